@@ -0,0 +1,77 @@
+#include "AlertPropagation.h"
+
+#include "NeighborLists.h"
+#include "VehicleStore.h"
+
+#include <algorithm>
+
+const AlertPropagationResult& AlertPropagation::propagate(const V2VMessage& alert, int sourceIndex,
+                                                          const NeighborLists& neighbors,
+                                                          const VehicleStore& vehicles) {
+    m_result = AlertPropagationResult();
+    m_result.messageId = alert.messageId;
+    m_result.sourceIndex = sourceIndex;
+    m_result.triggerTimeMs = alert.timestamp;
+    if (sourceIndex < 0 || sourceIndex >= vehicles.size()) return m_result;
+
+    if (m_visitedStamp.size() != vehicles.size()) {
+        m_visitedStamp.fill(0, vehicles.size());
+        m_emitterOf.fill(-1, vehicles.size());
+        m_stamp = 0;
+    }
+    if (++m_stamp == 0) {
+        // Débordement de l'estampille : remise à zéro complète
+        m_visitedStamp.fill(0);
+        m_stamp = 1;
+    }
+    const quint32 stamp = m_stamp;
+    m_visitedStamp[sourceIndex] = stamp;
+
+    m_frontier.clear();
+    m_frontier.append(sourceIndex);
+    int receivedTtl = alert.ttl; // TTL porté par les messages reçus au saut courant
+
+    for (int hop = 1; !m_frontier.isEmpty(); ++hop) {
+        const qint64 deliveryTimeMs = alert.timestamp + hop * m_hopLatencyMs;
+        m_nextFrontier.clear();
+
+        for (int emitterIndex : std::as_const(m_frontier)) {
+            const int reachedBefore = m_nextFrontier.size();
+            neighbors.forEachInRange(emitterIndex, vehicles, [&](int receiverIndex) {
+                if (m_visitedStamp.at(receiverIndex) == stamp) return;
+                m_visitedStamp[receiverIndex] = stamp;
+                m_emitterOf[receiverIndex] = emitterIndex;
+                m_nextFrontier.append(receiverIndex);
+            });
+
+            // Un relais ne compte que s'il a atteint au moins un nouveau véhicule
+            if (emitterIndex != sourceIndex && m_nextFrontier.size() > reachedBefore) {
+                m_result.relayIndices.append(emitterIndex);
+            }
+        }
+        if (m_nextFrontier.isEmpty()) break;
+
+        // Ordre canonique au sein d'un saut : le bilan ne dépend pas de l'ordre des listes
+        std::sort(m_nextFrontier.begin(), m_nextFrontier.end());
+        for (int receiverIndex : std::as_const(m_nextFrontier)) {
+            m_result.receptions.append({receiverIndex, m_emitterOf.at(receiverIndex), hop, deliveryTimeMs});
+        }
+        m_result.maxHopCount = hop;
+
+        // Les véhicules de ce saut ne relaient que si le TTL reçu est positif
+        if (receivedTtl <= 0) break;
+        --receivedTtl;
+        m_frontier.swap(m_nextFrontier);
+    }
+
+    return m_result;
+}
+
+void AlertPropagation::clear() {
+    m_result = AlertPropagationResult();
+    m_visitedStamp.clear();
+    m_emitterOf.clear();
+    m_stamp = 0;
+    m_frontier.clear();
+    m_nextFrontier.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include "V2VMessage.h"
+
+class NeighborLists;
+class VehicleStore;
+
+// Réception d'une alerte par un véhicule
+struct AlertReception {
+    int vehicleIndex = -1;
+    int emitterIndex = -1;          // Véhicule (source ou relais) dont elle a été reçue
+    int hopCount = 0;               // 1 = voisin direct de l'émetteur
+    qint64 deliveryTimeMs = 0;      // Temps simulé de réception
+};
+
+// Bilan de la propagation d'une alerte
+struct AlertPropagationResult {
+    quint64 messageId = 0;
+    int sourceIndex = -1;
+    qint64 triggerTimeMs = 0;
+    QVector<AlertReception> receptions; // Par saut croissant, puis par indice de véhicule
+    QVector<int> relayIndices;          // Relais ayant atteint au moins un nouveau véhicule
+    int maxHopCount = 0;
+};
+
+// Propagation multi-sauts d'une alerte en une seule passe : parcours en largeur
+// du graphe de voisinage courant (véhicules à portée radio), borné par le TTL.
+// Comme avec le relais de boîte en boîte, un véhicule reçoit l'alerte avec le
+// TTL restant et ne la relaie que si celui-ci est positif : une alerte de TTL 3
+// atteint au plus 4 sauts. Chaque véhicule est atteint au plus une fois, le
+// coût est proportionnel au nombre de liens parcourus.
+class AlertPropagation {
+public:
+    static constexpr qint64 DEFAULT_HOP_LATENCY_MS = 16; // Latence simulée par saut (~ un pas)
+
+    void setHopLatencyMs(qint64 latencyMs) { m_hopLatencyMs = qMax<qint64>(latencyMs, 0); }
+    qint64 hopLatencyMs() const { return m_hopLatencyMs; }
+
+    // Propage alert (émise par sourceIndex à alert.timestamp) et retourne le bilan.
+    // Le résultat reste valide jusqu'au prochain appel.
+    const AlertPropagationResult& propagate(const V2VMessage& alert, int sourceIndex,
+                                            const NeighborLists& neighbors, const VehicleStore& vehicles);
+    const AlertPropagationResult& lastResult() const { return m_result; }
+    void clear();
+
+private:
+    qint64 m_hopLatencyMs = DEFAULT_HOP_LATENCY_MS;
+    AlertPropagationResult m_result;
+
+    // Marquage des véhicules atteints : une estampille par propagation évite
+    // de remettre le tableau à zéro à chaque alerte
+    QVector<quint32> m_visitedStamp;
+    QVector<int> m_emitterOf;       // Valide pour les véhicules marqués par la propagation courante
+    quint32 m_stamp = 0;
+    QVector<int> m_frontier;
+    QVector<int> m_nextFrontier;
+};
@@ -0,0 +1,557 @@
+#include "ContractionHierarchy.h"
+
+#include "RoadGraph.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QPair>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace {
+constexpr double INFINITE_WEIGHT = std::numeric_limits<double>::infinity();
+
+// Recherche de témoin bornée : plus court chemin depuis source dans le graphe
+// des nœuds non contractés, sans passer par le nœud en cours de contraction
+class WitnessSearch {
+public:
+    void run(int source, int excludedNode, double maxWeight,
+             const QVector<QVector<int>>& outgoing, const QVector<bool>& contracted,
+             const QVector<int>& arcTargets, const QVector<double>& arcWeights) {
+        if (m_distance.size() != outgoing.size()) {
+            m_distance.fill(INFINITE_WEIGHT, outgoing.size());
+            m_stamp.fill(0, outgoing.size());
+            m_currentStamp = 0;
+        }
+        if (++m_currentStamp == 0) {
+            m_stamp.fill(0);
+            m_currentStamp = 1;
+        }
+
+        m_heap.clear();
+        setDistance(source, 0.0);
+        m_heap.append({0.0, source});
+
+        int settled = 0;
+        while (!m_heap.isEmpty() && settled < ContractionHierarchy::WITNESS_SETTLE_LIMIT) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<QPair<double, int>>());
+            const QPair<double, int> entry = m_heap.takeLast();
+            const int node = entry.second;
+            if (entry.first > distance(node)) continue;
+            if (entry.first > maxWeight) break;
+            ++settled;
+
+            for (int arcIndex : outgoing.at(node)) {
+                const int next = arcTargets.at(arcIndex);
+                if (next == excludedNode || contracted.at(next)) continue;
+                const double candidate = entry.first + arcWeights.at(arcIndex);
+                if (candidate < distance(next)) {
+                    setDistance(next, candidate);
+                    m_heap.append({candidate, next});
+                    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<QPair<double, int>>());
+                }
+            }
+        }
+    }
+
+    double distance(int node) const {
+        return m_stamp.at(node) == m_currentStamp ? m_distance.at(node) : INFINITE_WEIGHT;
+    }
+
+private:
+    QVector<double> m_distance;
+    QVector<quint32> m_stamp;
+    quint32 m_currentStamp = 0;
+    QVector<QPair<double, int>> m_heap;
+
+    void setDistance(int node, double value) {
+        m_distance[node] = value;
+        m_stamp[node] = m_currentStamp;
+    }
+};
+} // namespace
+
+double ContractionHierarchy::travelTimeSeconds(const RoadGraph& graph, int edgeIndex) {
+    const double speedKmh = std::max(graph.edgeAttributes(edgeIndex).maxSpeedKmh, 1.0);
+    return graph.edges().at(edgeIndex).lengthMeters * 3.6 / speedKmh;
+}
+
+quint64 ContractionHierarchy::fingerprint(const RoadGraph& graph) {
+    // FNV-1a sur ce qui détermine les arcs : extrémités, sens et poids
+    quint64 hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](quint64 value) {
+        hash ^= value;
+        hash *= 0x100000001b3ULL;
+    };
+    mix(static_cast<quint64>(graph.nodes().size()));
+    mix(static_cast<quint64>(graph.edges().size()));
+    for (int i = 0; i < graph.edges().size(); ++i) {
+        const RoadEdge& edge = graph.edges().at(i);
+        const double weight = travelTimeSeconds(graph, i);
+        quint64 weightBits = 0;
+        std::memcpy(&weightBits, &weight, sizeof(weightBits));
+        mix(static_cast<quint32>(edge.fromNode));
+        mix(static_cast<quint32>(edge.toNode));
+        mix(graph.edgeAttributes(i).oneway ? 1 : 0);
+        mix(weightBits);
+    }
+    return hash;
+}
+
+bool ContractionHierarchy::matches(const RoadGraph& graph) const {
+    return !isEmpty() && nodeCount() == graph.nodes().size() && m_graphFingerprint == fingerprint(graph);
+}
+
+ContractionHierarchy ContractionHierarchy::build(const RoadGraph& graph) {
+    ContractionHierarchy hierarchy;
+    const int nodeCount = graph.nodes().size();
+    hierarchy.m_graphFingerprint = fingerprint(graph);
+    hierarchy.m_rank.fill(-1, nodeCount);
+    QVector<Arc>& arcs = hierarchy.m_arcs;
+
+    // Graphe de travail : listes d'arcs par nœud, cibles et poids en tableaux
+    // parallèles pour les recherches de témoin
+    QVector<QVector<int>> outgoing(nodeCount);
+    QVector<QVector<int>> incoming(nodeCount);
+    QVector<int> arcTargets;
+    QVector<double> arcWeights;
+    auto addArc = [&](const Arc& arc) {
+        outgoing[arc.source].append(arcs.size());
+        incoming[arc.target].append(arcs.size());
+        arcTargets.append(arc.target);
+        arcWeights.append(arc.weight);
+        arcs.append(arc);
+    };
+
+    // Arcs d'origine : un seul arc (le plus rapide) par paire de nœuds
+    auto addOriginalArc = [&](int source, int target, double weight, int edgeIndex, bool forward) {
+        if (source == target) return;
+        for (int arcIndex : std::as_const(outgoing[source])) {
+            Arc& existing = arcs[arcIndex];
+            if (existing.target != target) continue;
+            if (weight < existing.weight) {
+                existing.weight = weight;
+                existing.edgeIndex = edgeIndex;
+                existing.forward = forward;
+                arcWeights[arcIndex] = weight;
+            }
+            return;
+        }
+        Arc arc;
+        arc.source = source;
+        arc.target = target;
+        arc.weight = weight;
+        arc.edgeIndex = edgeIndex;
+        arc.forward = forward;
+        addArc(arc);
+    };
+
+    const auto& edges = graph.edges();
+    for (int i = 0; i < edges.size(); ++i) {
+        const RoadEdge& edge = edges.at(i);
+        if (edge.fromNode < 0 || edge.toNode < 0 ||
+            edge.fromNode >= nodeCount || edge.toNode >= nodeCount) {
+            continue;
+        }
+        const double weight = travelTimeSeconds(graph, i);
+        addOriginalArc(edge.fromNode, edge.toNode, weight, i, true);
+        if (!graph.edgeAttributes(i).oneway) {
+            addOriginalArc(edge.toNode, edge.fromNode, weight, i, false);
+        }
+    }
+
+    QVector<bool> contracted(nodeCount, false);
+    QVector<int> contractedNeighbors(nodeCount, 0);
+    WitnessSearch witness;
+
+    // Contraction (ou simulation) de v : retourne le nombre de raccourcis nécessaires
+    auto contractNode = [&](int v, bool simulate) {
+        int shortcuts = 0;
+        for (int inIndex : std::as_const(incoming[v])) {
+            const int u = arcs.at(inIndex).source;
+            const double inWeight = arcs.at(inIndex).weight;
+            if (contracted.at(u)) continue;
+
+            double maxWeight = -1.0;
+            for (int outIndex : std::as_const(outgoing[v])) {
+                const int w = arcTargets.at(outIndex);
+                if (w == u || contracted.at(w)) continue;
+                maxWeight = std::max(maxWeight, inWeight + arcWeights.at(outIndex));
+            }
+            if (maxWeight < 0.0) continue;
+
+            witness.run(u, v, maxWeight, outgoing, contracted, arcTargets, arcWeights);
+
+            for (int outIndex : std::as_const(outgoing[v])) {
+                const int w = arcTargets.at(outIndex);
+                if (w == u || contracted.at(w)) continue;
+                const double shortcutWeight = inWeight + arcWeights.at(outIndex);
+                if (witness.distance(w) <= shortcutWeight) continue;
+
+                ++shortcuts;
+                if (!simulate) {
+                    Arc shortcut;
+                    shortcut.source = u;
+                    shortcut.target = w;
+                    shortcut.weight = shortcutWeight;
+                    shortcut.firstChild = inIndex;
+                    shortcut.secondChild = outIndex;
+                    addArc(shortcut);
+                }
+            }
+        }
+        return shortcuts;
+    };
+
+    // Priorité : différence d'arêtes + voisins déjà contractés (répartition uniforme)
+    auto priority = [&](int v) {
+        int removedArcs = 0;
+        for (int arcIndex : std::as_const(incoming[v])) {
+            if (!contracted.at(arcs.at(arcIndex).source)) ++removedArcs;
+        }
+        for (int arcIndex : std::as_const(outgoing[v])) {
+            if (!contracted.at(arcTargets.at(arcIndex))) ++removedArcs;
+        }
+        return contractNode(v, true) - removedArcs + contractedNeighbors.at(v);
+    };
+
+    // File de priorité à mise à jour paresseuse : la priorité d'un nœud est
+    // recalculée quand il sort de la file et il y est remis si elle a augmenté
+    using QueueEntry = QPair<int, int>; // (priorité, nœud)
+    QVector<QueueEntry> queue;
+    queue.reserve(nodeCount);
+    for (int v = 0; v < nodeCount; ++v) {
+        queue.append(qMakePair(priority(v), v));
+    }
+    std::make_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+
+    int order = 0;
+    while (!queue.isEmpty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        const int v = queue.takeLast().second;
+
+        const int current = priority(v);
+        if (!queue.isEmpty() && current > queue.first().first) {
+            queue.append(qMakePair(current, v));
+            std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+            continue;
+        }
+
+        hierarchy.m_shortcutCount += contractNode(v, false);
+        contracted[v] = true;
+        hierarchy.m_rank[v] = order++;
+
+        for (int arcIndex : std::as_const(incoming[v])) {
+            ++contractedNeighbors[arcs.at(arcIndex).source];
+        }
+        for (int arcIndex : std::as_const(outgoing[v])) {
+            ++contractedNeighbors[arcTargets.at(arcIndex)];
+        }
+    }
+
+    // Graphes de recherche en CSR : arcs montants par source, arcs descendants par cible
+    const QVector<int>& rank = hierarchy.m_rank;
+    hierarchy.m_upwardOffsets.fill(0, nodeCount + 1);
+    hierarchy.m_downwardOffsets.fill(0, nodeCount + 1);
+    for (const Arc& arc : std::as_const(arcs)) {
+        if (rank.at(arc.target) > rank.at(arc.source)) {
+            ++hierarchy.m_upwardOffsets[arc.source + 1];
+        } else {
+            ++hierarchy.m_downwardOffsets[arc.target + 1];
+        }
+    }
+    for (int n = 0; n < nodeCount; ++n) {
+        hierarchy.m_upwardOffsets[n + 1] += hierarchy.m_upwardOffsets[n];
+        hierarchy.m_downwardOffsets[n + 1] += hierarchy.m_downwardOffsets[n];
+    }
+    hierarchy.m_upwardArcs.resize(hierarchy.m_upwardOffsets[nodeCount]);
+    hierarchy.m_downwardArcs.resize(hierarchy.m_downwardOffsets[nodeCount]);
+    QVector<int> upCursor(hierarchy.m_upwardOffsets.constBegin(), hierarchy.m_upwardOffsets.constEnd() - 1);
+    QVector<int> downCursor(hierarchy.m_downwardOffsets.constBegin(), hierarchy.m_downwardOffsets.constEnd() - 1);
+    for (int i = 0; i < arcs.size(); ++i) {
+        const Arc& arc = arcs.at(i);
+        if (rank.at(arc.target) > rank.at(arc.source)) {
+            hierarchy.m_upwardArcs[upCursor[arc.source]++] = i;
+        } else {
+            hierarchy.m_downwardArcs[downCursor[arc.target]++] = i;
+        }
+    }
+
+    return hierarchy;
+}
+
+bool ContractionHierarchy::save(const QString& filePath, QString* errorMessage) const {
+    // Fichier temporaire renommé par commit() : une écriture interrompue ne
+    // laisse jamais de hiérarchie tronquée à la place de la précédente
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Impossible d'écrire la hiérarchie de routage: %1").arg(file.errorString());
+        }
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << FILE_MAGIC << FILE_VERSION << m_graphFingerprint << static_cast<qint32>(m_shortcutCount);
+    out << m_rank;
+    out << static_cast<qint32>(m_arcs.size());
+    for (const Arc& arc : m_arcs) {
+        out << static_cast<qint32>(arc.source) << static_cast<qint32>(arc.target) << arc.weight
+            << static_cast<qint32>(arc.edgeIndex) << arc.forward
+            << static_cast<qint32>(arc.firstChild) << static_cast<qint32>(arc.secondChild);
+    }
+    out << m_upwardOffsets << m_upwardArcs << m_downwardOffsets << m_downwardArcs;
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Erreur d'écriture de la hiérarchie de routage: %1").arg(file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
+
+bool ContractionHierarchy::load(const QString& filePath, const RoadGraph& graph, ContractionHierarchy& hierarchy,
+                                QString* errorMessage) {
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("Impossible d'ouvrir la hiérarchie de routage: %1").arg(file.errorString()));
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 graphFingerprint = 0;
+    qint32 shortcutCount = 0;
+    in >> magic >> version >> graphFingerprint >> shortcutCount;
+    if (magic != FILE_MAGIC || version != FILE_VERSION) {
+        return fail(QStringLiteral("Format de hiérarchie de routage non reconnu"));
+    }
+    if (graphFingerprint != fingerprint(graph)) {
+        return fail(QStringLiteral("La hiérarchie de routage ne correspond pas au graphe chargé"));
+    }
+
+    ContractionHierarchy loaded;
+    loaded.m_graphFingerprint = graphFingerprint;
+    loaded.m_shortcutCount = shortcutCount;
+    in >> loaded.m_rank;
+
+    qint32 arcCount = 0;
+    in >> arcCount;
+    if (in.status() != QDataStream::Ok || arcCount < 0) {
+        return fail(QStringLiteral("Hiérarchie de routage tronquée"));
+    }
+    loaded.m_arcs.resize(arcCount);
+    for (Arc& arc : loaded.m_arcs) {
+        qint32 source = 0, target = 0, edgeIndex = 0, firstChild = 0, secondChild = 0;
+        in >> source >> target >> arc.weight >> edgeIndex >> arc.forward >> firstChild >> secondChild;
+        arc.source = source;
+        arc.target = target;
+        arc.edgeIndex = edgeIndex;
+        arc.firstChild = firstChild;
+        arc.secondChild = secondChild;
+    }
+    in >> loaded.m_upwardOffsets >> loaded.m_upwardArcs >> loaded.m_downwardOffsets >> loaded.m_downwardArcs;
+    if (in.status() != QDataStream::Ok) {
+        return fail(QStringLiteral("Hiérarchie de routage tronquée"));
+    }
+
+    // Cohérence minimale avant d'accepter des indices lus sur disque
+    const int nodeCount = graph.nodes().size();
+    bool valid = loaded.m_rank.size() == nodeCount &&
+                 loaded.m_upwardOffsets.size() == nodeCount + 1 &&
+                 loaded.m_downwardOffsets.size() == nodeCount + 1 &&
+                 loaded.m_upwardOffsets.last() == loaded.m_upwardArcs.size() &&
+                 loaded.m_downwardOffsets.last() == loaded.m_downwardArcs.size();
+    for (int i = 0; valid && i < loaded.m_arcs.size(); ++i) {
+        const Arc& arc = loaded.m_arcs.at(i);
+        valid = arc.source >= 0 && arc.source < nodeCount && arc.target >= 0 && arc.target < nodeCount &&
+                (arc.edgeIndex >= 0 ? arc.edgeIndex < graph.edges().size()
+                                    : arc.firstChild >= 0 && arc.firstChild < i &&
+                                      arc.secondChild >= 0 && arc.secondChild < i);
+    }
+    for (int arcIndex : std::as_const(loaded.m_upwardArcs)) {
+        valid = valid && arcIndex >= 0 && arcIndex < loaded.m_arcs.size();
+    }
+    for (int arcIndex : std::as_const(loaded.m_downwardArcs)) {
+        valid = valid && arcIndex >= 0 && arcIndex < loaded.m_arcs.size();
+    }
+    if (!valid) {
+        return fail(QStringLiteral("Hiérarchie de routage corrompue"));
+    }
+
+    hierarchy = std::move(loaded);
+    return true;
+}
+
+// ========== Requêtes ==========
+
+void RouteQuery::prepare(int nodeCount) {
+    for (SearchSpace* space : {&m_forward, &m_backward}) {
+        if (space->distance.size() != nodeCount) {
+            space->distance.fill(INFINITE_WEIGHT, nodeCount);
+            space->parentArc.fill(-1, nodeCount);
+            space->stamp.fill(0, nodeCount);
+            m_stamp = 0;
+        }
+        space->heap.clear();
+    }
+    if (++m_stamp == 0) {
+        m_forward.stamp.fill(0);
+        m_backward.stamp.fill(0);
+        m_stamp = 1;
+    }
+}
+
+bool RouteQuery::route(const ContractionHierarchy& hierarchy, int sourceNode, int targetNode,
+                       QVector<RouteStep>& steps, double* travelTimeSeconds) {
+    steps.clear();
+    const int nodeCount = hierarchy.nodeCount();
+    if (sourceNode < 0 || sourceNode >= nodeCount || targetNode < 0 || targetNode >= nodeCount) {
+        return false;
+    }
+    if (sourceNode == targetNode) {
+        if (travelTimeSeconds) *travelTimeSeconds = 0.0;
+        return true;
+    }
+
+    prepare(nodeCount);
+    const quint32 stamp = m_stamp;
+    const auto greater = std::greater<HeapEntry>();
+
+    auto start = [&](SearchSpace& space, int node) {
+        space.distance[node] = 0.0;
+        space.parentArc[node] = -1;
+        space.stamp[node] = stamp;
+        space.heap.append({0.0, node});
+    };
+    start(m_forward, sourceNode);
+    start(m_backward, targetNode);
+
+    // Recherche bidirectionnelle montante : on développe toujours le côté dont la
+    // file a le plus petit minimum, jusqu'à ce que les deux minimums dépassent
+    // le meilleur chemin trouvé
+    double best = INFINITE_WEIGHT;
+    int meetingNode = -1;
+    while (!m_forward.heap.isEmpty() || !m_backward.heap.isEmpty()) {
+        const double forwardMin = m_forward.heap.isEmpty() ? INFINITE_WEIGHT : m_forward.heap.first().distance;
+        const double backwardMin = m_backward.heap.isEmpty() ? INFINITE_WEIGHT : m_backward.heap.first().distance;
+        if (std::min(forwardMin, backwardMin) >= best) break;
+
+        const bool forwardSide = forwardMin <= backwardMin;
+        SearchSpace& space = forwardSide ? m_forward : m_backward;
+        const SearchSpace& other = forwardSide ? m_backward : m_forward;
+
+        std::pop_heap(space.heap.begin(), space.heap.end(), greater);
+        const HeapEntry entry = space.heap.takeLast();
+        const int node = entry.node;
+        if (entry.distance > space.distance.at(node)) continue;
+
+        if (other.stamp.at(node) == stamp && entry.distance + other.distance.at(node) < best) {
+            best = entry.distance + other.distance.at(node);
+            meetingNode = node;
+        }
+
+        const QVector<int>& offsets = forwardSide ? hierarchy.m_upwardOffsets : hierarchy.m_downwardOffsets;
+        const QVector<int>& arcIndices = forwardSide ? hierarchy.m_upwardArcs : hierarchy.m_downwardArcs;
+        for (int k = offsets.at(node); k < offsets.at(node + 1); ++k) {
+            const int arcIndex = arcIndices.at(k);
+            const ContractionHierarchy::Arc& arc = hierarchy.m_arcs.at(arcIndex);
+            const int next = forwardSide ? arc.target : arc.source;
+            const double candidate = entry.distance + arc.weight;
+            if (space.stamp.at(next) != stamp || candidate < space.distance.at(next)) {
+                space.distance[next] = candidate;
+                space.parentArc[next] = arcIndex;
+                space.stamp[next] = stamp;
+                space.heap.append({candidate, next});
+                std::push_heap(space.heap.begin(), space.heap.end(), greater);
+            }
+        }
+    }
+
+    if (meetingNode < 0) return false;
+
+    // Arcs de la source au point de rencontre (remontés à l'envers), puis du
+    // point de rencontre à la cible, chacun déplié en arêtes d'origine
+    QVector<int> forwardArcs;
+    for (int node = meetingNode; m_forward.parentArc.at(node) >= 0;) {
+        const int arcIndex = m_forward.parentArc.at(node);
+        forwardArcs.append(arcIndex);
+        node = hierarchy.m_arcs.at(arcIndex).source;
+    }
+    for (int k = forwardArcs.size() - 1; k >= 0; --k) {
+        unpack(hierarchy, forwardArcs.at(k), steps);
+    }
+    for (int node = meetingNode; m_backward.parentArc.at(node) >= 0;) {
+        const int arcIndex = m_backward.parentArc.at(node);
+        unpack(hierarchy, arcIndex, steps);
+        node = hierarchy.m_arcs.at(arcIndex).target;
+    }
+
+    if (travelTimeSeconds) *travelTimeSeconds = best;
+    return true;
+}
+
+void RouteQuery::upwardSearch(const ContractionHierarchy& hierarchy, int node, bool forward,
+                              QVector<SettledNode>& settled) {
+    settled.clear();
+    const int nodeCount = hierarchy.nodeCount();
+    if (node < 0 || node >= nodeCount) return;
+
+    prepare(nodeCount);
+    const quint32 stamp = m_stamp;
+    const auto greater = std::greater<HeapEntry>();
+    SearchSpace& space = m_forward;
+    const QVector<int>& offsets = forward ? hierarchy.m_upwardOffsets : hierarchy.m_downwardOffsets;
+    const QVector<int>& arcIndices = forward ? hierarchy.m_upwardArcs : hierarchy.m_downwardArcs;
+
+    space.distance[node] = 0.0;
+    space.stamp[node] = stamp;
+    space.heap.append({0.0, node});
+    while (!space.heap.isEmpty()) {
+        std::pop_heap(space.heap.begin(), space.heap.end(), greater);
+        const HeapEntry entry = space.heap.takeLast();
+        if (entry.distance > space.distance.at(entry.node)) continue;
+        settled.append({entry.node, entry.distance});
+
+        for (int k = offsets.at(entry.node); k < offsets.at(entry.node + 1); ++k) {
+            const ContractionHierarchy::Arc& arc = hierarchy.m_arcs.at(arcIndices.at(k));
+            const int next = forward ? arc.target : arc.source;
+            const double candidate = entry.distance + arc.weight;
+            if (space.stamp.at(next) != stamp || candidate < space.distance.at(next)) {
+                space.distance[next] = candidate;
+                space.stamp[next] = stamp;
+                space.heap.append({candidate, next});
+                std::push_heap(space.heap.begin(), space.heap.end(), greater);
+            }
+        }
+    }
+}
+
+void RouteQuery::unpack(const ContractionHierarchy& hierarchy, int arcIndex, QVector<RouteStep>& steps) {
+    m_unpackStack.clear();
+    m_unpackStack.append(arcIndex);
+    while (!m_unpackStack.isEmpty()) {
+        const ContractionHierarchy::Arc& arc = hierarchy.m_arcs.at(m_unpackStack.takeLast());
+        if (arc.edgeIndex >= 0) {
+            steps.append({arc.edgeIndex, arc.forward});
+        } else {
+            m_unpackStack.append(arc.secondChild);
+            m_unpackStack.append(arc.firstChild);
+        }
+    }
+}
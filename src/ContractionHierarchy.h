@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+class RoadGraph;
+
+// Étape d'un itinéraire : arête du graphe routier et sens de parcours
+struct RouteStep {
+    int edgeIndex = -1;
+    bool forward = true; // true : fromNode -> toNode
+};
+
+// Hiérarchie de contraction du graphe routier pour le calcul d'itinéraires.
+// Le prétraitement contracte les nœuds un à un (ordre par différence d'arêtes,
+// mis à jour paresseusement) en ajoutant des raccourcis lorsque aucun chemin
+// témoin n'est trouvé ; une requête est ensuite une recherche bidirectionnelle
+// qui ne monte que vers des nœuds de rang supérieur et ne visite que quelques
+// centaines de nœuds, même sur une ville entière.
+// Poids des arcs : temps de parcours (s) à la vitesse maximale de la voie. Une
+// arête non oneway peut être parcourue dans les deux sens, comme dans la simulation.
+class ContractionHierarchy {
+public:
+    static constexpr int WITNESS_SETTLE_LIMIT = 64; // Nœuds explorés au plus par recherche de témoin
+
+    // Prétraitement complet (le graphe doit être chargé ; l'adjacence n'est pas requise)
+    static ContractionHierarchy build(const RoadGraph& graph);
+
+    bool isEmpty() const { return m_rank.isEmpty(); }
+    int nodeCount() const { return m_rank.size(); }
+    int shortcutCount() const { return m_shortcutCount; }
+    // La hiérarchie a-t-elle été construite pour ce graphe (nœuds, arêtes, poids) ?
+    bool matches(const RoadGraph& graph) const;
+
+    // Persistance à côté du graphe (fichier binaire versionné)
+    bool save(const QString& filePath, QString* errorMessage = nullptr) const;
+    static bool load(const QString& filePath, const RoadGraph& graph, ContractionHierarchy& hierarchy,
+                     QString* errorMessage = nullptr);
+
+    static double travelTimeSeconds(const RoadGraph& graph, int edgeIndex);
+
+private:
+    friend class RouteQuery;
+
+    static constexpr quint32 FILE_MAGIC = 0x56324348; // "V2CH"
+    static constexpr quint32 FILE_VERSION = 1;
+
+    // Arc de la hiérarchie : arête d'origine (edgeIndex >= 0) ou raccourci
+    // source -> milieu -> cible décrit par ses deux arcs enfants
+    struct Arc {
+        int source = -1;
+        int target = -1;
+        double weight = 0.0;
+        int edgeIndex = -1;
+        bool forward = true;
+        int firstChild = -1;
+        int secondChild = -1;
+    };
+
+    static quint64 fingerprint(const RoadGraph& graph);
+
+    quint64 m_graphFingerprint = 0;
+    int m_shortcutCount = 0;
+    QVector<int> m_rank;
+    QVector<Arc> m_arcs;
+    // Arcs montants partant de chaque nœud (recherche avant), CSR
+    QVector<int> m_upwardOffsets;
+    QVector<int> m_upwardArcs;
+    // Arcs arrivant à chaque nœud depuis un nœud de rang supérieur (recherche arrière), CSR
+    QVector<int> m_downwardOffsets;
+    QVector<int> m_downwardArcs;
+};
+
+// Nœud atteint par une recherche montante et son temps de parcours (s)
+struct SettledNode {
+    int node = -1;
+    double seconds = 0.0;
+};
+
+// Requête d'itinéraire sur une hiérarchie. Les tableaux de travail sont conservés
+// d'une requête à l'autre (estampilles) : une instance par thread appelant.
+class RouteQuery {
+public:
+    // Itinéraire le plus rapide de sourceNode à targetNode (indices de nœuds).
+    // Retourne false si la cible est inaccessible.
+    bool route(const ContractionHierarchy& hierarchy, int sourceNode, int targetNode,
+               QVector<RouteStep>& steps, double* travelTimeSeconds = nullptr);
+
+    // Espace de recherche montant complet de node : vers l'avant (trajets partant
+    // de node) ou vers l'arrière (trajets arrivant à node). Base des requêtes
+    // plusieurs-à-plusieurs ; settled reçoit chaque nœud atteint avec sa distance.
+    void upwardSearch(const ContractionHierarchy& hierarchy, int node, bool forward,
+                      QVector<SettledNode>& settled);
+
+private:
+    struct HeapEntry {
+        double distance;
+        int node;
+        bool operator>(const HeapEntry& other) const {
+            return distance > other.distance || (distance == other.distance && node > other.node);
+        }
+    };
+
+    struct SearchSpace {
+        QVector<double> distance;
+        QVector<int> parentArc;
+        QVector<quint32> stamp;
+        QVector<HeapEntry> heap;
+    };
+
+    SearchSpace m_forward;
+    SearchSpace m_backward;
+    quint32 m_stamp = 0;
+    QVector<int> m_unpackStack;
+
+    void prepare(int nodeCount);
+    void unpack(const ContractionHierarchy& hierarchy, int arcIndex, QVector<RouteStep>& steps);
+};
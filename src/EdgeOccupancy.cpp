@@ -0,0 +1,216 @@
+#include "EdgeOccupancy.h"
+
+#include "RoadGraph.h"
+#include "VehicleStore.h"
+
+#include <algorithm>
+
+void EdgeOccupancy::reset(const RoadGraph& graph) {
+    const int lanes = graph.edges().size() * 2;
+    m_laneHead.fill(NO_VEHICLE, lanes);
+    m_laneTail.fill(NO_VEHICLE, lanes);
+    m_laneLength.fill(0, lanes);
+    m_laneSorted.fill(false, lanes);
+    m_sortedLanes.clear();
+    m_inverseLength = graph.edgeGeometry().inverseLength;
+    m_lane.clear();
+    m_previous.clear();
+    m_next.clear();
+}
+
+void EdgeOccupancy::build(const RoadGraph& graph, const VehicleStore& vehicles) {
+    reset(graph);
+    m_lane.reserve(vehicles.size());
+    m_previous.reserve(vehicles.size());
+    m_next.reserve(vehicles.size());
+    for (int i = 0; i < vehicles.size(); ++i) {
+        insert(i, vehicles);
+    }
+}
+
+void EdgeOccupancy::insert(int vehicleIndex, const VehicleStore& vehicles) {
+    if (vehicleIndex >= m_lane.size()) {
+        m_lane.resize(vehicleIndex + 1);
+        m_previous.resize(vehicleIndex + 1);
+        m_next.resize(vehicleIndex + 1);
+    }
+    m_lane[vehicleIndex] = NO_VEHICLE;
+    m_previous[vehicleIndex] = NO_VEHICLE;
+    m_next[vehicleIndex] = NO_VEHICLE;
+
+    const int lane = laneOf(vehicles.edgeIndices().at(vehicleIndex), vehicles.isMovingForward(vehicleIndex));
+    if (lane >= 0 && lane < laneCount()) {
+        linkAtRear(vehicleIndex, lane);
+        settle(vehicleIndex, vehicles);
+    }
+}
+
+void EdgeOccupancy::update(const VehicleStore& vehicles) {
+    const int count = std::min<int>(vehicles.size(), m_lane.size());
+
+    // 1. Changements de voie (transitions d'arête, demi-tours)
+    for (int i = 0; i < count; ++i) {
+        int lane = laneOf(vehicles.edgeIndices().at(i), vehicles.isMovingForward(i));
+        if (lane < 0 || lane >= laneCount()) lane = NO_VEHICLE;
+        if (lane == m_lane.at(i)) continue;
+        unlink(i);
+        if (lane != NO_VEHICLE) {
+            linkAtRear(i, lane); // Entrée par le début de l'arête, remis en ordre ci-dessous
+        }
+    }
+
+    // 2. Ordre au sein des voies : tri par insertion de chaque voie occupée.
+    // Un settle() par véhicule ne suffit pas : deux dépassements dans la même
+    // voie peuvent laisser une paire désordonnée derrière un véhicule déjà traité.
+    for (int i = 0; i < count; ++i) {
+        const int lane = m_lane.at(i);
+        if (lane == NO_VEHICLE || m_laneSorted.at(lane)) continue;
+        m_laneSorted[lane] = true;
+        m_sortedLanes.append(lane);
+        sortLane(lane, vehicles);
+    }
+    for (int lane : std::as_const(m_sortedLanes)) {
+        m_laneSorted[lane] = false;
+    }
+    m_sortedLanes.clear();
+}
+
+void EdgeOccupancy::clear() {
+    m_laneHead.clear();
+    m_laneTail.clear();
+    m_laneLength.clear();
+    m_laneSorted.clear();
+    m_sortedLanes.clear();
+    m_inverseLength.clear();
+    m_lane.clear();
+    m_previous.clear();
+    m_next.clear();
+}
+
+int EdgeOccupancy::queueLength(int edgeIndex, bool movingForward) const {
+    const int lane = laneOf(edgeIndex, movingForward);
+    if (lane < 0 || lane >= laneCount()) return 0;
+    return m_laneLength.at(lane);
+}
+
+double EdgeOccupancy::densityPerKm(int edgeIndex) const {
+    if (edgeIndex < 0 || edgeIndex >= m_inverseLength.size()) return 0.0;
+    return vehicleCountOnEdge(edgeIndex) * m_inverseLength.at(edgeIndex) * 1000.0;
+}
+
+double EdgeOccupancy::gapToLeaderMeters(int vehicleIndex, const VehicleStore& vehicles) const {
+    const int leaderIndex = leader(vehicleIndex);
+    if (leaderIndex == NO_VEHICLE) return -1.0;
+    const double inverseLength = m_inverseLength.at(vehicles.edgeIndices().at(vehicleIndex));
+    if (inverseLength <= 0.0) return 0.0;
+    return (progress(leaderIndex, vehicles) - progress(vehicleIndex, vehicles)) / inverseLength;
+}
+
+int EdgeOccupancy::frontVehicle(int edgeIndex, bool movingForward) const {
+    const int lane = laneOf(edgeIndex, movingForward);
+    if (lane < 0 || lane >= laneCount()) return NO_VEHICLE;
+    return m_laneTail.at(lane);
+}
+
+int EdgeOccupancy::rearVehicle(int edgeIndex, bool movingForward) const {
+    const int lane = laneOf(edgeIndex, movingForward);
+    if (lane < 0 || lane >= laneCount()) return NO_VEHICLE;
+    return m_laneHead.at(lane);
+}
+
+double EdgeOccupancy::progress(int vehicleIndex, const VehicleStore& vehicles) {
+    // Avancement dans le sens de marche : 0 à l'entrée de l'arête, 1 à la sortie
+    const double position = std::clamp(vehicles.positionsOnEdge().at(vehicleIndex), 0.0, 1.0);
+    return vehicles.isMovingForward(vehicleIndex) ? position : 1.0 - position;
+}
+
+bool EdgeOccupancy::isBehind(int a, int b, const VehicleStore& vehicles) {
+    // Ordre total (égalités départagées par indice) : files identiques d'une exécution à l'autre
+    const double progressA = progress(a, vehicles);
+    const double progressB = progress(b, vehicles);
+    return progressA < progressB || (progressA == progressB && a < b);
+}
+
+void EdgeOccupancy::linkAtRear(int vehicleIndex, int lane) {
+    const int next = m_laneHead.at(lane);
+    m_lane[vehicleIndex] = lane;
+    m_previous[vehicleIndex] = NO_VEHICLE;
+    m_next[vehicleIndex] = next;
+    m_laneHead[lane] = vehicleIndex;
+    if (next != NO_VEHICLE) {
+        m_previous[next] = vehicleIndex;
+    } else {
+        m_laneTail[lane] = vehicleIndex;
+    }
+    ++m_laneLength[lane];
+}
+
+void EdgeOccupancy::settle(int vehicleIndex, const VehicleStore& vehicles) {
+    // Échanges adjacents jusqu'à ce que le véhicule soit entre ses voisins
+    while (m_next.at(vehicleIndex) != NO_VEHICLE && isBehind(m_next.at(vehicleIndex), vehicleIndex, vehicles)) {
+        swapWithNext(vehicleIndex);
+    }
+    while (m_previous.at(vehicleIndex) != NO_VEHICLE && isBehind(vehicleIndex, m_previous.at(vehicleIndex), vehicles)) {
+        swapWithNext(m_previous.at(vehicleIndex));
+    }
+}
+
+void EdgeOccupancy::sortLane(int lane, const VehicleStore& vehicles) {
+    // De l'arrière vers l'avant : la partie déjà parcourue reste triée, chaque
+    // véhicule y recule par échanges adjacents. O(longueur + inversions).
+    int vehicleIndex = m_laneHead.at(lane);
+    while (vehicleIndex != NO_VEHICLE) {
+        const int next = m_next.at(vehicleIndex);
+        while (m_previous.at(vehicleIndex) != NO_VEHICLE && isBehind(vehicleIndex, m_previous.at(vehicleIndex), vehicles)) {
+            swapWithNext(m_previous.at(vehicleIndex));
+        }
+        vehicleIndex = next;
+    }
+}
+
+void EdgeOccupancy::unlink(int vehicleIndex) {
+    const int lane = m_lane.at(vehicleIndex);
+    if (lane == NO_VEHICLE) return;
+
+    const int previous = m_previous.at(vehicleIndex);
+    const int next = m_next.at(vehicleIndex);
+    if (previous != NO_VEHICLE) {
+        m_next[previous] = next;
+    } else {
+        m_laneHead[lane] = next;
+    }
+    if (next != NO_VEHICLE) {
+        m_previous[next] = previous;
+    } else {
+        m_laneTail[lane] = previous;
+    }
+    --m_laneLength[lane];
+
+    m_lane[vehicleIndex] = NO_VEHICLE;
+    m_previous[vehicleIndex] = NO_VEHICLE;
+    m_next[vehicleIndex] = NO_VEHICLE;
+}
+
+void EdgeOccupancy::swapWithNext(int vehicleIndex) {
+    // ... p, a, b, n ...  ->  ... p, b, a, n ...
+    const int lane = m_lane.at(vehicleIndex);
+    const int a = vehicleIndex;
+    const int b = m_next.at(a);
+    const int p = m_previous.at(a);
+    const int n = m_next.at(b);
+
+    if (p != NO_VEHICLE) {
+        m_next[p] = b;
+    } else {
+        m_laneHead[lane] = b;
+    }
+    if (n != NO_VEHICLE) {
+        m_previous[n] = a;
+    } else {
+        m_laneTail[lane] = a;
+    }
+    m_previous[b] = p;
+    m_next[b] = a;
+    m_previous[a] = b;
+    m_next[a] = n;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+class RoadGraph;
+class VehicleStore;
+
+// Occupation des arêtes : pour chaque voie (arête, sens de marche), la file des
+// véhicules ordonnée de l'arrière vers l'avant selon leur avancement sur l'arête.
+// Les files sont des listes doublement chaînées intrusives (un précédent et un
+// suivant par véhicule) : meneur, suiveur et longueur de file en O(1).
+//
+// Invariant d'entrée : un véhicule qui change de voie entre par le début de
+// l'arête (avancement ~0), il est donc chaîné en O(1) à l'arrière de la file
+// d'arrivée. Le léger désordre possible (reliquat de déplacement au-delà d'un
+// véhicule déjà entré) est corrigé par échanges adjacents, en O(véhicules dépassés).
+class EdgeOccupancy {
+public:
+    static constexpr int NO_VEHICLE = -1;
+
+    // Dimensionne les voies pour le graphe et vide les files
+    void reset(const RoadGraph& graph);
+    // reset() puis insertion de tous les véhicules
+    void build(const RoadGraph& graph, const VehicleStore& vehicles);
+    // Insère un véhicule nouvellement ajouté au store dans sa file, à sa place
+    // (position quelconque : O(véhicules qu'il précède sur la voie))
+    void insert(int vehicleIndex, const VehicleStore& vehicles);
+    // Resynchronise les files après le déplacement : véhicules ayant changé de
+    // voie, puis rétablissement de l'ordre (dépassements) par tri par insertion
+    // de chaque voie occupée.
+    // Coût O(N + inversions), proche de O(N) d'un pas à l'autre.
+    void update(const VehicleStore& vehicles);
+    void clear();
+
+    static int laneOf(int edgeIndex, bool movingForward) { return edgeIndex * 2 + (movingForward ? 0 : 1); }
+
+    // Nombre de véhicules sur une voie, ou sur l'arête dans les deux sens
+    int queueLength(int edgeIndex, bool movingForward) const;
+    int vehicleCountOnEdge(int edgeIndex) const {
+        return queueLength(edgeIndex, true) + queueLength(edgeIndex, false);
+    }
+    // Densité de l'arête (véhicules par km, deux sens confondus)
+    double densityPerKm(int edgeIndex) const;
+
+    // Véhicule immédiatement devant / derrière sur la même voie (NO_VEHICLE sinon)
+    int leader(int vehicleIndex) const { return m_next.at(vehicleIndex); }
+    int follower(int vehicleIndex) const { return m_previous.at(vehicleIndex); }
+    // Écart (m) au meneur, ou -1 sans meneur sur la voie
+    double gapToLeaderMeters(int vehicleIndex, const VehicleStore& vehicles) const;
+
+    // Véhicule de tête (le plus proche de la sortie) et de queue d'une voie
+    int frontVehicle(int edgeIndex, bool movingForward) const;
+    int rearVehicle(int edgeIndex, bool movingForward) const;
+
+    // Parcourt les véhicules d'une voie de l'arrière vers l'avant : visit(vehicleIndex)
+    template <typename Visitor>
+    void forEachOnLane(int edgeIndex, bool movingForward, Visitor&& visit) const {
+        for (int i = rearVehicle(edgeIndex, movingForward); i != NO_VEHICLE; i = m_next.at(i)) {
+            visit(i);
+        }
+    }
+
+private:
+    QVector<int> m_laneHead;         // Véhicule de queue par voie
+    QVector<int> m_laneTail;         // Véhicule de tête par voie
+    QVector<int> m_laneLength;
+    QVector<bool> m_laneSorted;      // Voies déjà triées pendant update() (remis à faux ensuite)
+    QVector<int> m_sortedLanes;
+    QVector<double> m_inverseLength; // 1 / longueur (m) par arête, partagé avec la géométrie
+
+    // Par véhicule
+    QVector<int> m_lane;
+    QVector<int> m_previous;
+    QVector<int> m_next;
+
+    int laneCount() const { return m_laneHead.size(); }
+    static double progress(int vehicleIndex, const VehicleStore& vehicles);
+    static bool isBehind(int a, int b, const VehicleStore& vehicles);
+    void linkAtRear(int vehicleIndex, int lane);
+    void settle(int vehicleIndex, const VehicleStore& vehicles);
+    void sortLane(int lane, const VehicleStore& vehicles);
+    void unlink(int vehicleIndex);
+    void swapWithNext(int vehicleIndex);
+};
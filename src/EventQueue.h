@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <algorithm>
+
+// Type d'événement planifié sur le temps simulé
+enum class SimulationEventType {
+    CAM     // Émission d'un message CAM par un véhicule
+};
+
+struct SimulationEvent {
+    qint64 timeMs = 0;              // Échéance (temps simulé, ms)
+    int vehicleIndex = -1;
+    SimulationEventType type = SimulationEventType::CAM;
+};
+
+// File d'événements à temps discret (tas binaire sur l'échéance).
+// À échéance égale, les événements sortent par indice de véhicule croissant :
+// l'ordre de traitement est déterministe.
+class EventQueue {
+public:
+    bool isEmpty() const { return m_heap.isEmpty(); }
+    int size() const { return m_heap.size(); }
+    void clear() { m_heap.clear(); }
+    void reserve(int count) { m_heap.reserve(count); }
+
+    void push(const SimulationEvent& event) {
+        m_heap.append(event);
+        std::push_heap(m_heap.begin(), m_heap.end(), &EventQueue::later);
+    }
+
+    const SimulationEvent& top() const { return m_heap.first(); }
+
+    SimulationEvent pop() {
+        std::pop_heap(m_heap.begin(), m_heap.end(), &EventQueue::later);
+        SimulationEvent event = m_heap.last();
+        m_heap.removeLast();
+        return event;
+    }
+
+    // Y a-t-il un événement dont l'échéance est atteinte à timeMs ?
+    bool hasDueEvent(qint64 timeMs) const { return !m_heap.isEmpty() && m_heap.first().timeMs <= timeMs; }
+
+private:
+    // Ordre du tas : l'événement le plus tôt en tête
+    static bool later(const SimulationEvent& a, const SimulationEvent& b) {
+        if (a.timeMs != b.timeMs) return a.timeMs > b.timeMs;
+        if (a.vehicleIndex != b.vehicleIndex) return a.vehicleIndex > b.vehicleIndex;
+        return static_cast<int>(a.type) > static_cast<int>(b.type);
+    }
+
+    QVector<SimulationEvent> m_heap;
+};
@@ -13,13 +13,13 @@
 #include <QPainter>
 #include <limits>
 #include <utility>
-#include <random>
 #include <cmath>
 #include <algorithm>
 #include <QToolButton>
 #include <QStyle>
 #include <QTimer>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QDateTime>
 #include <QMenu>
 #include <QPair>
@@ -37,9 +37,10 @@
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QFrame>
+#include <QProgressBar>
 #include <QLineF>
 
-#include "RoadGraphLoader.h"
+#include "RoadGraphLoadTask.h"
 #include "V2VMessage.h"
 
 MapView::MapView(QWidget* parent) : QGraphicsView(parent), m_scene(new QGraphicsScene(this)) {
@@ -55,14 +56,13 @@ MapView::MapView(QWidget* parent) : QGraphicsView(parent), m_scene(new QGraphics
 }
 
 MapView::~MapView() {
+    // Attend la fin d'un chargement en cours avant de détruire la vue
+    delete m_roadGraphLoadTask;
+    m_roadGraphLoadTask = nullptr;
     if (m_simulationTimer) {
         m_simulationTimer->stop();
         delete m_simulationTimer;
     }
-    if (m_camMessageTimer) {
-        m_camMessageTimer->stop();
-        delete m_camMessageTimer;
-    }
     clearRoadGraphics();
     clearVehicleGraphics();
     clearConnectionGraphics();
@@ -221,7 +221,7 @@ void MapView::mousePressEvent(QMouseEvent* event) {
         
         if (vehicleIndex >= 0) {
             // Stocker le véhicule sélectionné pour déclencher alerte
-            m_selectedVehicleId = m_vehicles.at(vehicleIndex).id();
+            m_selectedVehicleId = m_snapshot.vehicles.at(vehicleIndex).id();
             // Afficher les informations du véhicule
             showVehicleInfoDialog(vehicleIndex);
             event->accept();
@@ -387,36 +387,98 @@ void MapView::loadVisibleTiles(const QPointF& centerScene) {
     updateZoomButtons();
 }
 
-bool MapView::loadRoadGraphFromFile(const QString& filePath) {
-    RoadGraph parsedGraph;
-    QString error;
-    if (!RoadGraphLoader::loadFromOsmFile(filePath, parsedGraph, &error)) {
-        qWarning() << "Échec du chargement du graphe routier:" << error;
-        return false;
+void MapView::loadRoadGraphFromFile(const QString& filePath) {
+    if (m_roadGraphLoadTask) {
+        // Le chargement précédent est abandonné ; son thread se termine seul
+        RoadGraphLoadTask* previous = m_roadGraphLoadTask;
+        m_roadGraphLoadTask = nullptr;
+        previous->disconnect(this);
+        previous->cancel();
+        if (previous->isRunning()) {
+            connect(previous, &RoadGraphLoadTask::finished, previous, &QObject::deleteLater);
+        } else {
+            previous->deleteLater();
+        }
+    }
+
+    m_roadGraphLoadTask = new RoadGraphLoadTask(filePath, this);
+    connect(m_roadGraphLoadTask, &RoadGraphLoadTask::progressChanged, this, &MapView::onRoadGraphLoadProgress);
+    connect(m_roadGraphLoadTask, &RoadGraphLoadTask::finished, this, &MapView::onRoadGraphLoadFinished);
+    m_loadStatusLabel->setText(tr("Chargement de %1…").arg(QFileInfo(filePath).fileName()));
+    m_loadProgressBar->setValue(0);
+    setLoadControlsVisible(true);
+    m_roadGraphLoadTask->start();
+}
+
+void MapView::onRoadGraphLoadProgress(qint64 processedBytes, qint64 totalBytes, qint64 wayCount) {
+    // Signaux déjà en file d'un chargement abandonné
+    if (!m_roadGraphLoadTask || sender() != m_roadGraphLoadTask) return;
+    if (totalBytes > 0) {
+        m_loadProgressBar->setValue(static_cast<int>(processedBytes * m_loadProgressBar->maximum() / totalBytes));
     }
+    m_loadStatusLabel->setText(tr("Chargement : %1 Mo, %2 voies")
+                                   .arg(processedBytes / (1024 * 1024))
+                                   .arg(wayCount));
+}
+
+void MapView::onCancelLoadClicked() {
+    if (m_roadGraphLoadTask) {
+        m_roadGraphLoadTask->cancel();
+        m_loadStatusLabel->setText(tr("Annulation…"));
+    }
+}
 
+void MapView::onRoadGraphLoadFinished(bool success, const QString& errorMessage) {
+    if (!m_roadGraphLoadTask || sender() != m_roadGraphLoadTask) return;
+    RoadGraphLoadTask* task = m_roadGraphLoadTask;
+    m_roadGraphLoadTask = nullptr;
+    setLoadControlsVisible(false);
+    task->deleteLater();
+
+    if (!success) {
+        if (task->isCancelRequested()) {
+            qInfo() << "Chargement du graphe routier annulé:" << task->filePath();
+        } else {
+            qWarning() << "Échec du chargement du graphe routier:" << errorMessage;
+        }
+        return;
+    }
+    applyRoadGraph(task->takeGraph(), task->hierarchyCachePath());
+}
+
+void MapView::setLoadControlsVisible(bool visible) {
+    m_loadStatusLabel->setVisible(visible);
+    m_loadProgressBar->setVisible(visible);
+    m_cancelLoadButton->setVisible(visible);
+    // Le panneau s'agrandit si nécessaire pendant le chargement
+    m_controlPanel->resize(m_controlPanel->width(), std::max(350, m_controlPanel->sizeHint().height()));
+}
+
+void MapView::applyRoadGraph(RoadGraph graph, const QString& hierarchyCachePath) {
     clearRoadGraphics();
     clearVehicleGraphics();
     clearConnectionGraphics();
     for (auto it = m_tileItems.begin(); it != m_tileItems.end(); ++it) {
         it->stillNeeded = false;
     }
-    m_roadGraph = std::move(parsedGraph);
-    m_roadGraphLoaded = true;
+    // La hiérarchie de routage est conservée à côté du cache du graphe
+    m_engine.setRoadGraph(std::move(graph), hierarchyCachePath);
+    const RoadGraph& roadGraph = m_engine.roadGraph();
     
     // Générer les véhicules seulement si le graphe contient des données
-    if (!m_roadGraph.nodes().isEmpty() && !m_roadGraph.edges().isEmpty()) {
-        generateVehicles(30); // Réduit à 30 véhicules pour tester (peut être augmenté plus tard)
+    if (!roadGraph.nodes().isEmpty() && !roadGraph.edges().isEmpty()) {
+        m_engine.generateVehicles(30); // Réduit à 30 véhicules pour tester (peut être augmenté plus tard)
     } else {
         qWarning() << "Graphe routier vide, aucun véhicule généré";
     }
+    refreshSnapshot();
 
-    if (!m_roadGraph.nodes().isEmpty()) {
+    if (!roadGraph.nodes().isEmpty()) {
         double minLat = std::numeric_limits<double>::max();
         double maxLat = std::numeric_limits<double>::lowest();
         double minLon = std::numeric_limits<double>::max();
         double maxLon = std::numeric_limits<double>::lowest();
-        for (const auto& node : m_roadGraph.nodes()) {
+        for (const auto& node : roadGraph.nodes()) {
             minLat = std::min(minLat, node.lat);
             maxLat = std::max(maxLat, node.lat);
             minLon = std::min(minLon, node.lon);
@@ -430,9 +492,8 @@ bool MapView::loadRoadGraphFromFile(const QString& filePath) {
         reloadVehicleGraphics();
     }
 
-    qInfo() << "Graphe routier chargé:" << m_roadGraph.nodes().size()
-            << "noeuds," << m_roadGraph.edges().size() << "arêtes.";
-    return true;
+    qInfo() << "Graphe routier chargé:" << roadGraph.nodes().size()
+            << "noeuds," << roadGraph.edges().size() << "arêtes.";
 }
 
 void MapView::onTileReady(int z, int x, int y, const QPixmap& pix) {
@@ -473,25 +534,34 @@ void MapView::clearRoadGraphics() {
 
 void MapView::reloadRoadGraphics() {
     clearRoadGraphics();
-    if (!m_roadGraphLoaded) return;
+    if (!m_engine.hasRoadGraph()) return;
 
     QPen pen(Qt::red);
     pen.setWidthF(1.5);
     pen.setCosmetic(true);
 
-    const auto& nodes = m_roadGraph.nodes();
-    for (const RoadEdge& edge : m_roadGraph.edges()) {
+    const auto& nodes = m_engine.roadGraph().nodes();
+    const auto& shapePoints = m_engine.roadGraph().shapePoints();
+    auto addSegment = [&](const QPointF& p1, const QPointF& p2) {
+        auto* line = m_scene->addLine(QLineF(p1, p2), pen);
+        line->setZValue(10);
+        m_roadGraphics.append(line);
+    };
+    for (const RoadEdge& edge : m_engine.roadGraph().edges()) {
         if (edge.fromNode < 0 || edge.toNode < 0 ||
             edge.fromNode >= nodes.size() || edge.toNode >= nodes.size()) {
             continue;
         }
         const RoadNode& fromNode = nodes.at(edge.fromNode);
         const RoadNode& toNode = nodes.at(edge.toNode);
-        QPointF p1 = lonLatToScene(fromNode.lon, fromNode.lat, m_zoom);
-        QPointF p2 = lonLatToScene(toNode.lon, toNode.lat, m_zoom);
-        auto* line = m_scene->addLine(QLineF(p1, p2), pen);
-        line->setZValue(10);
-        m_roadGraphics.append(line);
+        // Géométrie d'origine : un segment par paire de points de la polyligne
+        QPointF previous = lonLatToScene(fromNode.lon, fromNode.lat, m_zoom);
+        for (int k = edge.shapeBegin; k < edge.shapeEnd; ++k) {
+            QPointF point = lonLatToScene(shapePoints.at(k).lon, shapePoints.at(k).lat, m_zoom);
+            addSegment(previous, point);
+            previous = point;
+        }
+        addSegment(previous, lonLatToScene(toNode.lon, toNode.lat, m_zoom));
     }
     
     // Mettre à jour aussi les connexions V2V et la heatmap si activées
@@ -503,99 +573,6 @@ void MapView::reloadRoadGraphics() {
     }
 }
 
-void MapView::generateVehicles(int count) {
-    m_vehicles.clear();
-    if (!m_roadGraphLoaded) return;
-
-    const auto& edges = m_roadGraph.edges();
-    const auto& nodes = m_roadGraph.nodes();
-    if (edges.isEmpty() || nodes.isEmpty()) return;
-
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_real_distribution<double> tDist(0.0, 1.0);
-    std::uniform_real_distribution<double> radiusDist(100.0, 500.0);
-    std::uniform_int_distribution<int> directionDist(0, 1);
-
-    // Créer une liste d'arêtes valides
-    QVector<int> validEdgeIndices;
-    for (int i = 0; i < edges.size(); ++i) {
-        const RoadEdge& edge = edges.at(i);
-        if (edge.fromNode >= 0 && edge.toNode >= 0 &&
-            edge.fromNode < nodes.size() && edge.toNode < nodes.size()) {
-            validEdgeIndices.append(i);
-        }
-    }
-    
-    if (validEdgeIndices.isEmpty()) {
-        qWarning() << "Aucune arête valide trouvée pour générer des véhicules";
-        return;
-    }
-
-    std::uniform_int_distribution<int> edgeDist(0, validEdgeIndices.size() - 1);
-    
-    // Pour éviter de mettre plusieurs véhicules trop proches sur la même arête,
-    // on garde une trace des positions déjà utilisées par arête
-    QHash<int, QVector<double>> edgePositions; // edgeIndex -> positions déjà utilisées
-    
-    int vehicleId = 1;
-    int attempts = 0;
-    const int maxAttempts = count * 50; // Limite pour éviter boucle infinie
-    const double minDistanceOnEdge = 0.05; // Distance minimale entre véhicules sur la même arête (5%)
-    
-    while (vehicleId <= count && attempts < maxAttempts) {
-        attempts++;
-        
-        // Sélectionner une arête aléatoire
-        int randomEdgeIdx = validEdgeIndices.at(edgeDist(rng));
-        const RoadEdge& edge = edges.at(randomEdgeIdx);
-        
-        const RoadNode& fromNode = nodes.at(edge.fromNode);
-        const RoadNode& toNode = nodes.at(edge.toNode);
-        
-        // Générer une position aléatoire sur l'arête
-        double t = tDist(rng);
-        
-        // Vérifier que cette position n'est pas trop proche d'un autre véhicule sur la même arête
-        bool tooClose = false;
-        if (edgePositions.contains(randomEdgeIdx)) {
-            for (double existingT : edgePositions[randomEdgeIdx]) {
-                if (std::abs(t - existingT) < minDistanceOnEdge) {
-                    tooClose = true;
-                    break;
-                }
-            }
-        }
-        
-        if (tooClose) {
-            continue; // Essayer une autre position
-        }
-        
-        // Calculer les coordonnées géographiques
-        double lat = fromNode.lat + (toNode.lat - fromNode.lat) * t;
-        double lon = fromNode.lon + (toNode.lon - fromNode.lon) * t;
-
-        Vehicle vehicle;
-        vehicle.setId(vehicleId);
-        vehicle.setLatLon(lat, lon);
-        vehicle.setSpeedKmh(edge.maxSpeedKmh);
-        vehicle.setTransmissionRadiusMeters(radiusDist(rng));
-        vehicle.setEdgeId(edge.id);
-        vehicle.setHighwayType(edge.highwayType);
-        vehicle.setEdgeIndex(randomEdgeIdx);
-        vehicle.setPositionOnEdge(t);
-        vehicle.setMovingForward(directionDist(rng) == 1 || edge.oneway);
-        
-        m_vehicles.append(vehicle);
-        
-        // Enregistrer cette position pour cette arête
-        edgePositions[randomEdgeIdx].append(t);
-        
-        ++vehicleId;
-    }
-    
-    qInfo() << "Véhicules générés:" << m_vehicles.size() << "sur" << count << "demandés";
-}
-
 void MapView::clearVehicleGraphics() {
     for (QGraphicsEllipseItem* item : std::as_const(m_vehicleGraphics)) {
         if (item) {
@@ -608,15 +585,16 @@ void MapView::clearVehicleGraphics() {
 
 void MapView::reloadVehicleGraphics() {
     clearVehicleGraphics();
-    if (m_vehicles.isEmpty()) return;
+    if (m_snapshot.vehicles.isEmpty()) return;
 
     QPen pen(Qt::black);
     pen.setWidthF(1.0);
     pen.setCosmetic(true);
 
     constexpr double radiusPixels = 5.0;
+    const RoadGraph& graph = m_engine.roadGraph();
 
-    for (const Vehicle& vehicle : std::as_const(m_vehicles)) {
+    for (const Vehicle& vehicle : std::as_const(m_snapshot.vehicles)) {
         QPointF pos = lonLatToScene(vehicle.longitude(), vehicle.latitude(), m_zoom);
         QRectF rect(pos.x() - radiusPixels, pos.y() - radiusPixels, radiusPixels * 2, radiusPixels * 2);
         
@@ -632,13 +610,13 @@ void MapView::reloadVehicleGraphics() {
                                 .arg(vehicle.longitude(), 0, 'f', 6)
                                 .arg(vehicle.speedKmh(), 0, 'f', 1)
                                 .arg(vehicle.transmissionRadiusMeters(), 0, 'f', 1)
-                                .arg(vehicle.highwayType()));
+                                .arg(highwayClassName(graph.edgeAttributes(vehicle.edgeIndex()).highwayClass)));
         m_vehicleGraphics.append(ellipse);
     }
     
     // Mettre à jour les connexions V2V après le rechargement des véhicules
     // Toujours mettre à jour si on a des véhicules chargés
-    if (m_roadGraphLoaded && !m_vehicles.isEmpty()) {
+    if (m_engine.hasRoadGraph() && !m_snapshot.vehicles.isEmpty()) {
         if (m_showV2VConnections) {
             updateConnectionGraphics();
         }
@@ -854,16 +832,15 @@ void MapView::initializeSimulation() {
     m_simulationTimer->setInterval(16); // ~60 FPS
     connect(m_simulationTimer, &QTimer::timeout, this, &MapView::onSimulationTick);
     m_lastUpdateTime = QDateTime::currentMSecsSinceEpoch();
-    
-    // Timer pour messages CAM périodiques (500ms)
-    m_camMessageTimer = new QTimer(this);
-    m_camMessageTimer->setInterval(CAM_INTERVAL_MS);
-    connect(m_camMessageTimer, &QTimer::timeout, this, &MapView::onCAMTimerTimeout);
-    m_lastCamSendTime = QDateTime::currentMSecsSinceEpoch();
+    // Les messages CAM périodiques sont cadencés par le moteur sur le temps simulé
+}
+
+void MapView::refreshSnapshot() {
+    m_snapshot = m_engine.snapshot();
 }
 
 void MapView::onSimulationTick() {
-    if (!m_simulationRunning || !m_roadGraphLoaded) return;
+    if (!m_simulationRunning || !m_engine.hasRoadGraph()) return;
     
     qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
     qint64 deltaTimeMs = currentTime - m_lastUpdateTime;
@@ -875,15 +852,10 @@ void MapView::onSimulationTick() {
     double deltaTimeSeconds = (deltaTimeMs / 1000.0) * m_simulationSpeed;
     m_lastUpdateTime = currentTime;
     
-    updateVehiclePositions(deltaTimeSeconds);
+    // Avancer le moteur par pas fixes (déplacement, CAM, alertes, messages V2V)
+    m_engine.runFor(deltaTimeSeconds);
+    refreshSnapshot();
     
-    // Détecter les arrêts brutaux pour déclencher des alertes
-    detectEmergencyStop();
-    
-    // Traiter les messages V2V reçus
-    processV2VMessages();
-    
-    detectV2VConnections();
     updateVehicleVisualization(); // Mettre à jour les couleurs selon les alertes
     reloadVehicleGraphics();
     
@@ -893,7 +865,12 @@ void MapView::onSimulationTick() {
     } else {
         clearConnectionGraphics();
     }
-    
+
+    // Mettre à jour les échanges V2V (CAM reçus, liens de la dernière alerte) si activés
+    if (m_showV2VExchanges) {
+        updateV2VExchangeVisualization();
+    }
+
     // Mettre à jour la heatmap de densité si activée
     if (m_showDensityHeatmap) {
         updateDensityHeatmap();
@@ -902,163 +879,6 @@ void MapView::onSimulationTick() {
     }
 }
 
-void MapView::updateVehiclePositions(double deltaTimeSeconds) {
-    const auto& edges = m_roadGraph.edges();
-    const auto& nodes = m_roadGraph.nodes();
-    
-    for (Vehicle& vehicle : m_vehicles) {
-        int edgeIdx = vehicle.edgeIndex();
-        if (edgeIdx < 0 || edgeIdx >= edges.size()) continue;
-        
-        const RoadEdge& edge = edges.at(edgeIdx);
-        if (edge.fromNode < 0 || edge.toNode < 0 ||
-            edge.fromNode >= nodes.size() || edge.toNode >= nodes.size()) {
-            continue;
-        }
-        
-        // Mettre à jour la position sur l'arête
-        vehicle.updatePosition(deltaTimeSeconds, edge.lengthMeters);
-        
-        // Vérifier si le véhicule atteint une extrémité de l'arête
-        if ((vehicle.isMovingForward() && vehicle.positionOnEdge() >= 1.0) ||
-            (!vehicle.isMovingForward() && vehicle.positionOnEdge() <= 0.0)) {
-            updateVehicleOnEdge(vehicle, deltaTimeSeconds);
-        } else {
-            // Mettre à jour les coordonnées géographiques
-            const RoadNode& fromNode = nodes.at(edge.fromNode);
-            const RoadNode& toNode = nodes.at(edge.toNode);
-            double t = vehicle.positionOnEdge();
-            
-            if (!vehicle.isMovingForward()) {
-                t = 1.0 - t; // Inverser pour le sens inverse
-            }
-            
-            double lat = fromNode.lat + (toNode.lat - fromNode.lat) * t;
-            double lon = fromNode.lon + (toNode.lon - fromNode.lon) * t;
-            vehicle.setLatLon(lat, lon);
-        }
-    }
-}
-
-void MapView::updateVehicleOnEdge(Vehicle& vehicle, double deltaTimeSeconds) {
-    const auto& edges = m_roadGraph.edges();
-    const auto& nodes = m_roadGraph.nodes();
-    
-    int currentEdgeIdx = vehicle.edgeIndex();
-    if (currentEdgeIdx < 0 || currentEdgeIdx >= edges.size()) return;
-    
-    const RoadEdge& currentEdge = edges.at(currentEdgeIdx);
-    int currentNodeIdx = vehicle.isMovingForward() ? currentEdge.toNode : currentEdge.fromNode;
-    
-    if (currentNodeIdx < 0 || currentNodeIdx >= nodes.size()) return;
-    
-    // Trouver la prochaine arête
-    int nextEdgeIdx = selectNextEdge(currentNodeIdx, currentEdgeIdx, vehicle.isMovingForward());
-    
-    if (nextEdgeIdx >= 0 && nextEdgeIdx < edges.size()) {
-        const RoadEdge& nextEdge = edges.at(nextEdgeIdx);
-        
-        // Déterminer la direction sur la nouvelle arête
-        bool movingForward = (nextEdge.fromNode == currentNodeIdx);
-        
-        // Calculer la position restante après avoir quitté l'ancienne arête
-        double remainingProgress = 0.0;
-        if (vehicle.isMovingForward() && vehicle.positionOnEdge() >= 1.0) {
-            remainingProgress = (vehicle.positionOnEdge() - 1.0) * currentEdge.lengthMeters;
-        } else if (!vehicle.isMovingForward() && vehicle.positionOnEdge() <= 0.0) {
-            remainingProgress = (-vehicle.positionOnEdge()) * currentEdge.lengthMeters;
-        }
-        
-        // Positionner le véhicule sur la nouvelle arête
-        if (nextEdge.lengthMeters > 0) {
-            double newPosition = remainingProgress / nextEdge.lengthMeters;
-            if (!movingForward) {
-                newPosition = 1.0 - newPosition;
-            }
-            vehicle.setPositionOnEdge(std::clamp(newPosition, 0.0, 1.0));
-        } else {
-            vehicle.setPositionOnEdge(movingForward ? 0.0 : 1.0);
-        }
-        
-        vehicle.setEdgeIndex(nextEdgeIdx);
-        vehicle.setEdgeId(nextEdge.id);
-        vehicle.setMovingForward(movingForward);
-        vehicle.setSpeedKmh(nextEdge.maxSpeedKmh);
-        vehicle.setHighwayType(nextEdge.highwayType);
-        
-        // Mettre à jour les coordonnées
-        const RoadNode& fromNode = nodes.at(nextEdge.fromNode);
-        const RoadNode& toNode = nodes.at(nextEdge.toNode);
-        double t = vehicle.positionOnEdge();
-        if (!movingForward) {
-            t = 1.0 - t;
-        }
-        double lat = fromNode.lat + (toNode.lat - fromNode.lat) * t;
-        double lon = fromNode.lon + (toNode.lon - fromNode.lon) * t;
-        vehicle.setLatLon(lat, lon);
-    } else {
-        // Pas de prochaine arête trouvée, inverser la direction ou rester sur place
-        vehicle.setMovingForward(!vehicle.isMovingForward());
-        if (vehicle.isMovingForward()) {
-            vehicle.setPositionOnEdge(0.0);
-        } else {
-            vehicle.setPositionOnEdge(1.0);
-        }
-        
-        // Mettre à jour les coordonnées pour la position actuelle
-        const RoadNode& fromNode = nodes.at(currentEdge.fromNode);
-        const RoadNode& toNode = nodes.at(currentEdge.toNode);
-        double t = vehicle.positionOnEdge();
-        if (!vehicle.isMovingForward()) {
-            t = 1.0 - t;
-        }
-        double lat = fromNode.lat + (toNode.lat - fromNode.lat) * t;
-        double lon = fromNode.lon + (toNode.lon - fromNode.lon) * t;
-        vehicle.setLatLon(lat, lon);
-    }
-}
-
-int MapView::selectNextEdge(int currentNodeIndex, int currentEdgeIndex, bool movingForward) {
-    const auto& nodes = m_roadGraph.nodes();
-    if (currentNodeIndex < 0 || currentNodeIndex >= nodes.size()) return -1;
-    
-    const RoadNode& node = nodes.at(currentNodeIndex);
-    const auto& edges = m_roadGraph.edges();
-    
-    // Trouver toutes les arêtes sortantes de ce nœud
-    QVector<int> candidateEdges;
-    for (int i = 0; i < edges.size(); ++i) {
-        const RoadEdge& edge = edges.at(i);
-        if (edge.fromNode == currentNodeIndex && i != currentEdgeIndex) {
-            candidateEdges.append(i);
-        } else if (!edge.oneway && edge.toNode == currentNodeIndex && i != currentEdgeIndex) {
-            candidateEdges.append(i);
-        }
-    }
-    
-    if (candidateEdges.isEmpty()) {
-        // Chercher une arête bidirectionnelle en sens inverse
-        for (int i = 0; i < edges.size(); ++i) {
-            const RoadEdge& edge = edges.at(i);
-            if (edge.toNode == currentNodeIndex && !edge.oneway && i != currentEdgeIndex) {
-                candidateEdges.append(i);
-            }
-        }
-    }
-    
-    if (candidateEdges.isEmpty()) return -1;
-    
-    // Sélectionner aléatoirement une arête candidate
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_int_distribution<int> dist(0, candidateEdges.size() - 1);
-    return candidateEdges.at(dist(rng));
-}
-
-void MapView::detectV2VConnections() {
-    // Cette fonction sera appelée à chaque tick pour mettre à jour les connexions
-    // Les connexions sont calculées dans updateConnectionGraphics pour éviter de stocker l'état
-}
-
 void MapView::onDensityHeatmapToggled() {
     m_showDensityHeatmap = m_densityHeatmapButton->isChecked();
     if (m_showDensityHeatmap) {
@@ -1080,99 +900,28 @@ void MapView::onV2VConnectionsToggled() {
 void MapView::updateConnectionGraphics() {
     clearConnectionGraphics();
     
-    if (m_vehicles.isEmpty() || !m_showV2VConnections) return;
+    if (m_snapshot.vehicles.isEmpty() || !m_showV2VConnections) return;
     
     QPen connectionPen(QColor(0, 255, 0, 150)); // Vert semi-transparent
     connectionPen.setWidthF(1.0);
     connectionPen.setCosmetic(true);
     connectionPen.setStyle(Qt::DashLine);
     
-    // Optimisation : utiliser une grille spatiale pour réduire les comparaisons
-    // Taille de cellule : environ 1 km (0.009 degrés de latitude ≈ 1 km)
-    const double cellSize = 0.009; // ~1 km
-    QHash<QPair<int, int>, SpatialGridCell> grid;
-    buildSpatialGrid(grid, cellSize);
-    
-    // Parcourir les cellules de la grille et leurs voisines
-    QSet<QPair<int, int>> processedPairs;
-    
-    for (auto gridIt = grid.constBegin(); gridIt != grid.constEnd(); ++gridIt) {
-        const QPair<int, int>& cellKey = gridIt.key();
-        const SpatialGridCell& cell = gridIt.value();
-        
-        // Vérifier les véhicules dans la même cellule
-        for (int i = 0; i < cell.vehicleIndices.size(); ++i) {
-            int idx1 = cell.vehicleIndices.at(i);
-            for (int j = i + 1; j < cell.vehicleIndices.size(); ++j) {
-                int idx2 = cell.vehicleIndices.at(j);
-                QPair<int, int> pairKey = qMakePair(qMin(idx1, idx2), qMax(idx1, idx2));
-                if (processedPairs.contains(pairKey)) continue;
-                processedPairs.insert(pairKey);
-                
-                const Vehicle& v1 = m_vehicles.at(idx1);
-                const Vehicle& v2 = m_vehicles.at(idx2);
-                
-                double distance = calculateDistance(v1.latitude(), v1.longitude(),
-                                                    v2.latitude(), v2.longitude());
-                if (distance <= (v1.transmissionRadiusMeters() + v2.transmissionRadiusMeters())) {
-                    QPointF p1 = lonLatToScene(v1.longitude(), v1.latitude(), m_zoom);
-                    QPointF p2 = lonLatToScene(v2.longitude(), v2.latitude(), m_zoom);
-                    auto* line = m_scene->addLine(QLineF(p1, p2), connectionPen);
-                    line->setZValue(20);
-                    m_connectionGraphics.append(line);
-                }
-            }
-        }
-        
-        // Vérifier avec les cellules voisines (8 voisines)
-        for (int dx = -1; dx <= 1; ++dx) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                if (dx == 0 && dy == 0) continue;
-                QPair<int, int> neighborKey = qMakePair(cellKey.first + dx, cellKey.second + dy);
-                auto neighborIt = grid.find(neighborKey);
-                if (neighborIt == grid.end()) continue;
-                
-                const SpatialGridCell& neighborCell = neighborIt.value();
-                for (int idx1 : cell.vehicleIndices) {
-                    for (int idx2 : neighborCell.vehicleIndices) {
-                        QPair<int, int> pairKey = qMakePair(qMin(idx1, idx2), qMax(idx1, idx2));
-                        if (processedPairs.contains(pairKey)) continue;
-                        processedPairs.insert(pairKey);
-                        
-                        const Vehicle& v1 = m_vehicles.at(idx1);
-                        const Vehicle& v2 = m_vehicles.at(idx2);
-                        
-                        double distance = calculateDistance(v1.latitude(), v1.longitude(),
-                                                            v2.latitude(), v2.longitude());
-                        if (distance <= (v1.transmissionRadiusMeters() + v2.transmissionRadiusMeters())) {
-                            QPointF p1 = lonLatToScene(v1.longitude(), v1.latitude(), m_zoom);
-                            QPointF p2 = lonLatToScene(v2.longitude(), v2.latitude(), m_zoom);
-                            auto* line = m_scene->addLine(QLineF(p1, p2), connectionPen);
-                            line->setZValue(20);
-                            m_connectionGraphics.append(line);
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
+    // Paires à portée fournies par l'index spatial du moteur
+    const QVector<QPair<int, int>> pairs = m_engine.connectedVehiclePairs();
+    for (const QPair<int, int>& pair : pairs) {
+        if (pair.first >= m_snapshot.vehicles.size() || pair.second >= m_snapshot.vehicles.size()) continue;
 
-void MapView::buildSpatialGrid(QHash<QPair<int, int>, SpatialGridCell>& grid, double cellSize) const {
-    grid.clear();
-    for (int i = 0; i < m_vehicles.size(); ++i) {
-        const Vehicle& v = m_vehicles.at(i);
-        QPair<int, int> cellKey = getGridCell(v.latitude(), v.longitude(), cellSize);
-        grid[cellKey].vehicleIndices.append(i);
+        const Vehicle& v1 = m_snapshot.vehicles.at(pair.first);
+        const Vehicle& v2 = m_snapshot.vehicles.at(pair.second);
+        QPointF p1 = lonLatToScene(v1.longitude(), v1.latitude(), m_zoom);
+        QPointF p2 = lonLatToScene(v2.longitude(), v2.latitude(), m_zoom);
+        auto* line = m_scene->addLine(QLineF(p1, p2), connectionPen);
+        line->setZValue(20);
+        m_connectionGraphics.append(line);
     }
 }
 
-QPair<int, int> MapView::getGridCell(double lat, double lon, double cellSize) const {
-    int cellX = static_cast<int>(std::floor(lon / cellSize));
-    int cellY = static_cast<int>(std::floor(lat / cellSize));
-    return qMakePair(cellX, cellY);
-}
-
 void MapView::clearConnectionGraphics() {
     for (QGraphicsLineItem* item : std::as_const(m_connectionGraphics)) {
         if (item) {
@@ -1183,35 +932,18 @@ void MapView::clearConnectionGraphics() {
     m_connectionGraphics.clear();
 }
 
-double MapView::calculateDistance(double lat1, double lon1, double lat2, double lon2) const {
-    static constexpr double earthRadiusMeters = 6371000.0;
-    double lat1Rad = qDegreesToRadians(lat1);
-    double lon1Rad = qDegreesToRadians(lon1);
-    double lat2Rad = qDegreesToRadians(lat2);
-    double lon2Rad = qDegreesToRadians(lon2);
-    double dlat = lat2Rad - lat1Rad;
-    double dlon = lon2Rad - lon1Rad;
-    double a = qSin(dlat / 2) * qSin(dlat / 2) +
-               qCos(lat1Rad) * qCos(lat2Rad) * qSin(dlon / 2) * qSin(dlon / 2);
-    double c = 2 * qAtan2(qSqrt(a), qSqrt(1 - a));
-    return earthRadiusMeters * c;
-}
-
 void MapView::onPlayPauseClicked() {
     m_simulationRunning = !m_simulationRunning;
     
     if (m_simulationRunning) {
         m_simulationTimer->start();
-        m_camMessageTimer->start(); // Démarrer aussi le timer CAM
         m_lastUpdateTime = QDateTime::currentMSecsSinceEpoch();
-        m_lastCamSendTime = QDateTime::currentMSecsSinceEpoch();
         if (m_playPauseButton) {
             m_playPauseButton->setText("⏸");
             m_playPauseButton->setToolTip(tr("Pause"));
         }
     } else {
         m_simulationTimer->stop();
-        m_camMessageTimer->stop(); // Arrêter aussi le timer CAM
         if (m_playPauseButton) {
             m_playPauseButton->setText("▶");
             m_playPauseButton->setToolTip(tr("Play"));
@@ -1241,7 +973,7 @@ void MapView::onSpeedChanged(int speedIndex) {
 void MapView::updateDensityHeatmap() {
     clearDensityHeatmap();
     
-    if (m_vehicles.isEmpty() || !m_roadGraphLoaded) return;
+    if (m_snapshot.vehicles.isEmpty() || !m_engine.hasRoadGraph()) return;
     
     // Taille de cellule : 100 mètres
     const double cellSizeMeters = 100.0;
@@ -1319,7 +1051,7 @@ QColor MapView::getDensityColor(int vehicleCount, int maxCount) const {
 void MapView::buildDensityGrid(QHash<QPair<int, int>, DensityCell>& densityGrid, double cellSizeMeters) const {
     densityGrid.clear();
     
-    if (m_vehicles.isEmpty()) return;
+    if (m_snapshot.vehicles.isEmpty()) return;
     
     // Convertir la taille de cellule en degrés approximatifs
     // 1 degré de latitude ≈ 111 km, donc 100m ≈ 0.0009 degrés
@@ -1332,7 +1064,7 @@ void MapView::buildDensityGrid(QHash<QPair<int, int>, DensityCell>& densityGrid,
     double minLon = std::numeric_limits<double>::max();
     double maxLon = std::numeric_limits<double>::lowest();
     
-    for (const Vehicle& vehicle : m_vehicles) {
+    for (const Vehicle& vehicle : m_snapshot.vehicles) {
         minLat = std::min(minLat, vehicle.latitude());
         maxLat = std::max(maxLat, vehicle.latitude());
         minLon = std::min(minLon, vehicle.longitude());
@@ -1364,7 +1096,7 @@ void MapView::buildDensityGrid(QHash<QPair<int, int>, DensityCell>& densityGrid,
     }
     
     // Compter les véhicules dans chaque cellule
-    for (const Vehicle& vehicle : m_vehicles) {
+    for (const Vehicle& vehicle : m_snapshot.vehicles) {
         int cellX = static_cast<int>(std::floor(vehicle.longitude() / cellSizeDegrees));
         int cellY = static_cast<int>(std::floor(vehicle.latitude() / cellSizeDegrees));
         QPair<int, int> key = qMakePair(cellX, cellY);
@@ -1451,6 +1183,24 @@ void MapView::createControlPanel() {
     });
     vehicleCountLayout->addWidget(m_applyVehicleCountButton);
     m_controlLayout->addLayout(vehicleCountLayout);
+
+    // Chargement du graphe routier (visible seulement pendant un chargement)
+    m_loadStatusLabel = new QLabel(m_controlPanel);
+    m_controlLayout->addWidget(m_loadStatusLabel);
+
+    QHBoxLayout* loadLayout = new QHBoxLayout();
+    m_loadProgressBar = new QProgressBar(m_controlPanel);
+    m_loadProgressBar->setRange(0, 1000);
+    m_loadProgressBar->setTextVisible(false);
+    loadLayout->addWidget(m_loadProgressBar);
+
+    m_cancelLoadButton = new QPushButton(tr("Annuler"), m_controlPanel);
+    connect(m_cancelLoadButton, &QPushButton::clicked, this, &MapView::onCancelLoadClicked);
+    loadLayout->addWidget(m_cancelLoadButton);
+    m_controlLayout->addLayout(loadLayout);
+    m_loadStatusLabel->hide();
+    m_loadProgressBar->hide();
+    m_cancelLoadButton->hide();
     
     m_controlPanel->setLayout(m_controlLayout);
     m_controlPanel->resize(280, 350);
@@ -1490,7 +1240,7 @@ void MapView::onSpeedSliderChanged(int value) {
 }
 
 void MapView::onVehicleCountChanged(int count) {
-    if (!m_roadGraphLoaded) {
+    if (!m_engine.hasRoadGraph()) {
         qWarning() << "Aucun graphe routier chargé. Veuillez charger un fichier OSM d'abord.";
         return;
     }
@@ -1503,7 +1253,8 @@ void MapView::onVehicleCountChanged(int count) {
     }
     
     // Générer les nouveaux véhicules
-    generateVehicles(count);
+    m_engine.generateVehicles(count);
+    refreshSnapshot();
     
     // Recharger les graphiques
     reloadVehicleGraphics();
@@ -1515,14 +1266,14 @@ void MapView::onVehicleCountChanged(int count) {
         m_lastUpdateTime = QDateTime::currentMSecsSinceEpoch();
     }
     
-    qInfo() << "Nombre de véhicules changé à:" << m_vehicles.size();
+    qInfo() << "Nombre de véhicules changé à:" << m_snapshot.vehicles.size();
 }
 
 int MapView::findVehicleAtPosition(const QPointF& scenePos) const {
     constexpr double clickRadius = 10.0; // Rayon de détection en pixels
     
-    for (int i = 0; i < m_vehicles.size(); ++i) {
-        const Vehicle& vehicle = m_vehicles.at(i);
+    for (int i = 0; i < m_snapshot.vehicles.size(); ++i) {
+        const Vehicle& vehicle = m_snapshot.vehicles.at(i);
         QPointF vehiclePos = lonLatToScene(vehicle.longitude(), vehicle.latitude(), m_zoom);
         
         double distance = QLineF(scenePos, vehiclePos).length();
@@ -1535,9 +1286,9 @@ int MapView::findVehicleAtPosition(const QPointF& scenePos) const {
 }
 
 void MapView::showVehicleInfoDialog(int vehicleIndex) {
-    if (vehicleIndex < 0 || vehicleIndex >= m_vehicles.size()) return;
+    if (vehicleIndex < 0 || vehicleIndex >= m_snapshot.vehicles.size()) return;
     
-    const Vehicle& vehicle = m_vehicles.at(vehicleIndex);
+    const Vehicle& vehicle = m_snapshot.vehicles.at(vehicleIndex);
     
     QDialog* dialog = new QDialog(this);
     dialog->setWindowTitle(tr("Informations du Véhicule #%1").arg(vehicle.id()));
@@ -1562,21 +1313,16 @@ void MapView::showVehicleInfoDialog(int vehicleIndex) {
     formLayout->addRow(tr("Rayon de transmission:"), new QLabel(QString::number(vehicle.transmissionRadiusMeters(), 'f', 1) + tr(" m"), dialog));
     
     // Informations de route
-    formLayout->addRow(tr("Type de route:"), new QLabel(vehicle.highwayType(), dialog));
-    formLayout->addRow(tr("ID de l'arête:"), new QLabel(QString::number(vehicle.edgeId()), dialog));
+    const RoadGraph& graph = m_engine.roadGraph();
+    const int edgeIndex = vehicle.edgeIndex();
+    const qint64 edgeId = edgeIndex >= 0 && edgeIndex < graph.edges().size() ? graph.edges().at(edgeIndex).id : 0;
+    formLayout->addRow(tr("Type de route:"), new QLabel(highwayClassName(graph.edgeAttributes(edgeIndex).highwayClass), dialog));
+    formLayout->addRow(tr("ID de l'arête:"), new QLabel(QString::number(edgeId), dialog));
     
     // Compter les connexions V2V
     int connectionCount = 0;
     if (m_showV2VConnections) {
-        for (int i = 0; i < m_vehicles.size(); ++i) {
-            if (i == vehicleIndex) continue;
-            const Vehicle& other = m_vehicles.at(i);
-            double distance = calculateDistance(vehicle.latitude(), vehicle.longitude(),
-                                                other.latitude(), other.longitude());
-            if (distance <= (vehicle.transmissionRadiusMeters() + other.transmissionRadiusMeters())) {
-                connectionCount++;
-            }
-        }
+        connectionCount = m_engine.connectionCount(vehicleIndex);
     }
     formLayout->addRow(tr("Connexions V2V actives:"), new QLabel(QString::number(connectionCount), dialog));
     
@@ -1595,6 +1341,9 @@ void MapView::showVehicleInfoDialog(int vehicleIndex) {
         alertStatus = tr("✅ Normal");
     }
     formLayout->addRow(tr("État:"), new QLabel(alertStatus, dialog));
+    if (vehicle.hasReceivedAlert()) {
+        formLayout->addRow(tr("Sauts de l'alerte:"), new QLabel(QString::number(vehicle.alertHopCount()), dialog));
+    }
     
     mainLayout->addLayout(formLayout);
     
@@ -1610,174 +1359,16 @@ void MapView::showVehicleInfoDialog(int vehicleIndex) {
 
 // ========== Système de messages V2V ==========
 
-void MapView::onCAMTimerTimeout() {
-    if (!m_simulationRunning || !m_roadGraphLoaded) return;
-    sendCAMMessages();
-}
-
-void MapView::sendCAMMessages() {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    
-    for (Vehicle& vehicle : m_vehicles) {
-        // Créer un message CAM avec position et vitesse actuelles
-        V2VMessage camMessage(V2VMessageType::CAM, 
-                              vehicle.id(),
-                              vehicle.latitude(),
-                              vehicle.longitude(),
-                              vehicle.speedKmh(),
-                              1); // TTL = 1 pour CAM (pas de relais)
-        
-        // Trouver tous les véhicules à portée
-        for (int i = 0; i < m_vehicles.size(); ++i) {
-            if (i == vehicle.id() - 1) continue; // Ne pas s'envoyer à soi-même
-            
-            Vehicle& receiver = m_vehicles[i];
-            double distance = calculateDistance(vehicle.latitude(), vehicle.longitude(),
-                                              receiver.latitude(), receiver.longitude());
-            
-            if (distance <= (vehicle.transmissionRadiusMeters() + receiver.transmissionRadiusMeters())) {
-                receiver.addMessageToInbox(camMessage);
-            }
-        }
-        
-        vehicle.incrementMessagesSent();
-    }
-    
-    m_lastCamSendTime = currentTime;
-}
-
-void MapView::processV2VMessages() {
-    for (Vehicle& vehicle : m_vehicles) {
-        processVehicleInbox(vehicle);
-    }
-}
-
-void MapView::processVehicleInbox(Vehicle& vehicle) {
-    for (const V2VMessage& message : vehicle.getInbox()) {
-        // Vérifier si le message a déjà été traité (éviter boucles)
-        if (vehicle.getProcessedMessageIds().contains(message.messageId)) {
-            continue;
-        }
-        
-        vehicle.addProcessedMessageId(message.messageId);
-        vehicle.incrementMessagesReceived();
-        
-        if (message.type == V2VMessageType::ALERT) {
-            // Marquer le véhicule comme ayant reçu une alerte
-            vehicle.setReceivedAlert(true);
-            
-            // Relayer l'alerte si TTL > 0
-            if (message.ttl > 0) {
-                int vehicleIndex = vehicle.id() - 1;
-                if (vehicleIndex >= 0 && vehicleIndex < m_vehicles.size()) {
-                    relayAlertMessage(message, vehicleIndex);
-                    vehicle.incrementAlertsRelayed();
-                }
-            }
-        }
-    }
-    
-    // Vider l'inbox après traitement
-    vehicle.clearInbox();
-    
-    // Note: Le nettoyage des IDs traités n'est pas nécessaire car QSet gère efficacement
-    // la mémoire. Si nécessaire, on pourrait limiter la taille avec une approche différente
-    // (par exemple utiliser un QQueue avec timestamp pour garder l'ordre temporel)
-}
-
-void MapView::relayAlertMessage(const V2VMessage& alert, int receiverIndex) {
-    if (receiverIndex < 0 || receiverIndex >= m_vehicles.size()) return;
-    
-    Vehicle& receiver = m_vehicles[receiverIndex];
-    
-    // Créer une copie pour relais avec TTL décrémenté
-    V2VMessage relayedAlert = alert.createRelayCopy();
-    
-    // Trouver tous les véhicules à portée du relais
-    for (int i = 0; i < m_vehicles.size(); ++i) {
-        if (i == receiverIndex) continue;
-        
-        Vehicle& neighbor = m_vehicles[i];
-        double distance = calculateDistance(receiver.latitude(), receiver.longitude(),
-                                          neighbor.latitude(), neighbor.longitude());
-        
-        if (distance <= (receiver.transmissionRadiusMeters() + neighbor.transmissionRadiusMeters())) {
-            neighbor.addMessageToInbox(relayedAlert);
-        }
-    }
-}
-
-void MapView::detectEmergencyStop() {
-    const double speedDropThreshold = 30.0; // Réduction de vitesse de 30 km/h ou plus
-    
-    for (Vehicle& vehicle : m_vehicles) {
-        double currentSpeed = vehicle.speedKmh();
-        double previousSpeed = vehicle.previousSpeedKmh();
-        
-        // Initialiser la vitesse précédente si c'est la première fois
-        if (previousSpeed == 0.0 && vehicle.messagesSent() == 0) {
-            vehicle.setPreviousSpeedKmh(currentSpeed);
-            continue;
-        }
-        
-        // Détecter arrêt brutal : vitesse < seuil ET réduction importante
-        if (currentSpeed < EMERGENCY_STOP_THRESHOLD && 
-            previousSpeed > EMERGENCY_STOP_THRESHOLD &&
-            (previousSpeed - currentSpeed) >= speedDropThreshold) {
-            
-            // Déclencher une alerte
-            triggerAlertForVehicle(vehicle.id());
-        }
-        
-        // Stocker la vitesse actuelle pour la prochaine itération
-        vehicle.setPreviousSpeedKmh(currentSpeed);
-    }
-}
-
-void MapView::triggerAlertForVehicle(int vehicleId) {
-    int vehicleIndex = vehicleId - 1;
-    if (vehicleIndex < 0 || vehicleIndex >= m_vehicles.size()) return;
-    
-    Vehicle& vehicle = m_vehicles[vehicleIndex];
-    
-    // Ne pas déclencher plusieurs alertes pour le même véhicule
-    if (vehicle.hasActiveAlert()) return;
-    
-    vehicle.setActiveAlert(true);
-    
-    // Créer un message ALERT avec TTL = 3
-    V2VMessage alertMessage(V2VMessageType::ALERT,
-                            vehicle.id(),
-                            vehicle.latitude(),
-                            vehicle.longitude(),
-                            vehicle.speedKmh(),
-                            3); // TTL = 3 sauts
-    
-    // Envoyer l'alerte à tous les voisins à portée
-    for (int i = 0; i < m_vehicles.size(); ++i) {
-        if (i == vehicleIndex) continue;
-        
-        Vehicle& neighbor = m_vehicles[i];
-        double distance = calculateDistance(vehicle.latitude(), vehicle.longitude(),
-                                          neighbor.latitude(), neighbor.longitude());
-        
-        if (distance <= (vehicle.transmissionRadiusMeters() + neighbor.transmissionRadiusMeters())) {
-            neighbor.addMessageToInbox(alertMessage);
-        }
-    }
-    
-    vehicle.incrementMessagesSent();
-}
-
 void MapView::updateVehicleVisualization() {
     // Cette fonction sera appelée depuis reloadVehicleGraphics
     // Les couleurs seront mises à jour dans reloadVehicleGraphics
 }
 
 QColor MapView::getVehicleColor(const Vehicle& vehicle) const {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    // Les horodatages des alertes sont exprimés en temps simulé
+    qint64 currentTime = m_snapshot.simulationTimeMs;
     const qint64 alertBlinkInterval = 500; // 500ms pour le clignotement
-    const qint64 receivedAlertDuration = 3000; // 3 secondes pour l'orange
+    const qint64 receivedAlertDuration = SimulationEngine::RECEIVED_ALERT_DURATION_MS; // 3 secondes pour l'orange
     
     // Véhicule avec alerte active -> rouge clignotant
     if (vehicle.hasActiveAlert()) {
@@ -1795,10 +1386,8 @@ QColor MapView::getVehicleColor(const Vehicle& vehicle) const {
         qint64 timeSinceReceived = currentTime - vehicle.receivedAlertTimestamp();
         if (timeSinceReceived < receivedAlertDuration) {
             return QColor(255, 165, 0, 220); // Orange
-        } else {
-            // Réinitialiser après la durée
-            const_cast<Vehicle&>(vehicle).setReceivedAlert(false);
         }
+        // La réinitialisation après la durée est faite par le moteur
     }
     
     // Couleur par défaut : bleu
@@ -1807,7 +1396,9 @@ QColor MapView::getVehicleColor(const Vehicle& vehicle) const {
 
 void MapView::onTriggerAlertClicked() {
     if (m_selectedVehicleId > 0) {
-        triggerAlertForVehicle(m_selectedVehicleId);
+        m_engine.triggerAlertForVehicle(m_selectedVehicleId);
+        refreshSnapshot();
+        reloadVehicleGraphics();
     } else {
         qWarning() << "Aucun véhicule sélectionné. Cliquez sur un véhicule d'abord.";
     }
@@ -1825,10 +1416,10 @@ void MapView::onShowV2VExchangesToggled() {
 void MapView::updateV2VExchangeVisualization() {
     clearV2VExchangeGraphics();
     
-    if (m_vehicles.isEmpty() || !m_showV2VExchanges) return;
+    if (m_snapshot.vehicles.isEmpty() || !m_showV2VExchanges) return;
     
     // Afficher les lignes pour les messages en cours d'échange
-    // On visualise les messages dans les inbox des véhicules
+    // On visualise les CAM dans les inbox des véhicules
     QPen exchangePen(QColor(100, 200, 255, 120)); // Bleu clair semi-transparent pour les messages CAM
     exchangePen.setWidthF(1.5);
     exchangePen.setCosmetic(true);
@@ -1840,35 +1431,53 @@ void MapView::updateV2VExchangeVisualization() {
     alertPen.setStyle(Qt::SolidLine);
     
     // Parcourir tous les véhicules et afficher les messages dans leur inbox
-    for (int i = 0; i < m_vehicles.size(); ++i) {
-        const Vehicle& receiver = m_vehicles.at(i);
+    for (int i = 0; i < m_snapshot.vehicles.size(); ++i) {
+        const Vehicle& receiver = m_snapshot.vehicles.at(i);
         const QVector<V2VMessage>& inbox = receiver.getInbox();
         
         for (const V2VMessage& message : inbox) {
             // Trouver le véhicule émetteur
             int senderIndex = message.senderId - 1;
-            if (senderIndex < 0 || senderIndex >= m_vehicles.size() || senderIndex == i) continue;
+            if (senderIndex < 0 || senderIndex >= m_snapshot.vehicles.size() || senderIndex == i) continue;
             
-            const Vehicle& sender = m_vehicles.at(senderIndex);
+            const Vehicle& sender = m_snapshot.vehicles.at(senderIndex);
             
             // Calculer la distance pour vérifier si le message est toujours valide
-            double distance = calculateDistance(sender.latitude(), sender.longitude(),
-                                              receiver.latitude(), receiver.longitude());
+            double distance = SimulationEngine::calculateDistance(sender.latitude(), sender.longitude(),
+                                                                receiver.latitude(), receiver.longitude());
             
             // Afficher la ligne seulement si les véhicules sont toujours à portée
             if (distance <= (sender.transmissionRadiusMeters() + receiver.transmissionRadiusMeters())) {
                 QPointF senderPos = lonLatToScene(sender.longitude(), sender.latitude(), m_zoom);
                 QPointF receiverPos = lonLatToScene(receiver.longitude(), receiver.latitude(), m_zoom);
                 
-                // Utiliser une couleur différente pour les alertes
-                QPen* penToUse = (message.type == V2VMessageType::ALERT) ? &alertPen : &exchangePen;
-                
-                auto* line = m_scene->addLine(QLineF(senderPos, receiverPos), *penToUse);
+                auto* line = m_scene->addLine(QLineF(senderPos, receiverPos), exchangePen);
                 line->setZValue(25); // Entre les connexions V2V (20) et les véhicules (30)
                 m_v2vExchangeGraphics.append(line);
             }
         }
     }
+    
+    // Les alertes ne passent pas par les boîtes de réception : on trace les liens
+    // de la dernière propagation, saut par saut, pendant l'affichage de l'alerte
+    const AlertPropagationResult& alert = m_snapshot.lastAlert;
+    if (m_snapshot.simulationTimeMs - alert.triggerTimeMs >= SimulationEngine::RECEIVED_ALERT_DURATION_MS) return;
+    
+    for (const AlertReception& reception : alert.receptions) {
+        // Réceptions triées par saut, donc par heure de réception croissante
+        if (reception.deliveryTimeMs > m_snapshot.simulationTimeMs) break;
+        if (reception.emitterIndex < 0 || reception.emitterIndex >= m_snapshot.vehicles.size() ||
+            reception.vehicleIndex < 0 || reception.vehicleIndex >= m_snapshot.vehicles.size()) continue;
+        
+        const Vehicle& emitter = m_snapshot.vehicles.at(reception.emitterIndex);
+        const Vehicle& receiver = m_snapshot.vehicles.at(reception.vehicleIndex);
+        QPointF emitterPos = lonLatToScene(emitter.longitude(), emitter.latitude(), m_zoom);
+        QPointF receiverPos = lonLatToScene(receiver.longitude(), receiver.latitude(), m_zoom);
+        
+        auto* line = m_scene->addLine(QLineF(emitterPos, receiverPos), alertPen);
+        line->setZValue(25);
+        m_v2vExchangeGraphics.append(line);
+    }
 }
 
 void MapView::clearV2VExchangeGraphics() {
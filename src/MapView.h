@@ -18,13 +18,13 @@
 #include <QPushButton>
 
 #include "TileManager.h"
-#include "RoadGraph.h"
-#include "Vehicle.h"
-#include "V2VMessage.h"
+#include "SimulationEngine.h"
 
 class QGraphicsLineItem;
 class QGraphicsEllipseItem;
 class QGraphicsRectItem;
+class QProgressBar;
+class RoadGraphLoadTask;
 
 class MapView : public QGraphicsView {
     Q_OBJECT
@@ -33,7 +33,9 @@ public:
     ~MapView() override;
     void setCenterLatLon(double lat, double lon, int zoom, bool preserveIfOutOfBounds = false);
     void zoomToLevel(int newZoom);
-    bool loadRoadGraphFromFile(const QString& filePath);
+    // Lance le chargement en arrière-plan (un chargement en cours est annulé) ;
+    // le graphe remplace celui de la simulation une fois terminé
+    void loadRoadGraphFromFile(const QString& filePath);
 
 protected:
     void wheelEvent(QWheelEvent* event) override;
@@ -55,7 +57,9 @@ private slots:
     void onSpeedSliderChanged(int value);
     void onTriggerAlertClicked();
     void onShowV2VExchangesToggled();
-    void onCAMTimerTimeout();
+    void onRoadGraphLoadProgress(qint64 processedBytes, qint64 totalBytes, qint64 wayCount);
+    void onRoadGraphLoadFinished(bool success, const QString& errorMessage);
+    void onCancelLoadClicked();
 
 private:
     struct TileInfo {
@@ -66,9 +70,8 @@ private:
 
     TileManager m_tileManager;
     QGraphicsScene* m_scene;
-    RoadGraph m_roadGraph;
-    bool m_roadGraphLoaded = false;
-    QVector<Vehicle> m_vehicles;
+    SimulationEngine m_engine;
+    SimulationSnapshot m_snapshot; // Dernier état publié par le moteur (affichage)
     int m_zoom = 12;
     double m_centerLat = 47.750839;
     double m_centerLon = 7.335888;
@@ -85,15 +88,11 @@ private:
     QVector<QGraphicsLineItem*> m_v2vExchangeGraphics; // Lignes temporaires pour visualiser les échanges de messages
     QHash<QString, TileInfo> m_tileItems;
     
-    // Système de simulation
+    // Pilotage de la simulation (le calcul est délégué à m_engine)
     QTimer* m_simulationTimer = nullptr;
-    QTimer* m_camMessageTimer = nullptr; // Timer pour messages CAM périodiques (500ms)
     bool m_simulationRunning = false;
     double m_simulationSpeed = 1.0; // Multiplicateur de vitesse (0.5x, 1x, 2x, 5x)
     qint64 m_lastUpdateTime = 0;
-    qint64 m_lastCamSendTime = 0; // Dernier envoi de messages CAM
-    static constexpr qint64 CAM_INTERVAL_MS = 500; // Intervalle entre messages CAM (500ms)
-    static constexpr double EMERGENCY_STOP_THRESHOLD = 5.0; // Seuil de vitesse pour arrêt brutal (km/h)
     
     // Contrôles UI
     QToolButton* m_playPauseButton = nullptr;
@@ -114,7 +113,6 @@ private:
     void loadVisibleTiles(const QPointF& centerScene = QPointF());
     void reloadRoadGraphics();
     void clearRoadGraphics();
-    void generateVehicles(int count);
     void reloadVehicleGraphics();
     void clearVehicleGraphics();
     QString tileKey(int z, int x, int y) const;
@@ -147,18 +145,20 @@ private:
     QPushButton* m_applyVehicleCountButton = nullptr;
     void createControlPanel();
     void updateControlPanel();
+
+    // Chargement asynchrone du graphe routier
+    RoadGraphLoadTask* m_roadGraphLoadTask = nullptr;
+    QLabel* m_loadStatusLabel = nullptr;
+    QProgressBar* m_loadProgressBar = nullptr;
+    QPushButton* m_cancelLoadButton = nullptr;
+    void setLoadControlsVisible(bool visible);
+    void applyRoadGraph(RoadGraph graph, const QString& hierarchyCachePath);
     
     // Détection de clic sur véhicules
     int findVehicleAtPosition(const QPointF& scenePos) const;
     void showVehicleInfoDialog(int vehicleIndex);
     
-    // Système de messages V2V
-    void processV2VMessages();
-    void sendCAMMessages();
-    void processVehicleInbox(Vehicle& vehicle);
-    void relayAlertMessage(const V2VMessage& alert, int receiverIndex);
-    void detectEmergencyStop();
-    void triggerAlertForVehicle(int vehicleId);
+    // Visualisation des messages V2V
     void updateVehicleVisualization();
     QColor getVehicleColor(const Vehicle& vehicle) const;
     void updateV2VExchangeVisualization();
@@ -166,20 +166,9 @@ private:
     
     // Simulation
     void initializeSimulation();
-    void updateVehiclePositions(double deltaTimeSeconds);
-    void updateVehicleOnEdge(Vehicle& vehicle, double deltaTimeSeconds);
-    int selectNextEdge(int currentNodeIndex, int currentEdgeIndex, bool movingForward);
-    void detectV2VConnections();
+    void refreshSnapshot();
     void updateConnectionGraphics();
     void clearConnectionGraphics();
-    double calculateDistance(double lat1, double lon1, double lat2, double lon2) const;
-    
-    // Optimisation pour la détection V2V avec beaucoup de véhicules
-    struct SpatialGridCell {
-        QVector<int> vehicleIndices;
-    };
-    void buildSpatialGrid(QHash<QPair<int, int>, SpatialGridCell>& grid, double cellSize) const;
-    QPair<int, int> getGridCell(double lat, double lon, double cellSize) const;
     
     // Visualisation de densité (heatmap)
     void updateDensityHeatmap();
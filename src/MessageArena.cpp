@@ -0,0 +1,82 @@
+#include "MessageArena.h"
+
+#include <algorithm>
+
+void MessageArena::reset(int vehicleCount, int inboxCapacity) {
+    m_vehicleCount = std::max(vehicleCount, 0);
+    m_inboxCapacity = std::max(inboxCapacity, 1);
+    m_writeIndex = 0;
+    for (Buffer& buffer : m_buffers) {
+        buffer.messages.clear();
+        buffer.senders.clear();
+    }
+    m_senderOffsets.fill(0, m_vehicleCount + 1);
+    m_messagesBySender.clear();
+    m_inboxEntries.fill(-1, m_vehicleCount * m_inboxCapacity);
+    m_inboxSizes.fill(0, m_vehicleCount);
+    m_droppedCams.store(0, std::memory_order_relaxed);
+}
+
+void MessageArena::clear() {
+    reset(0, m_inboxCapacity);
+}
+
+void MessageArena::post(const V2VMessage& message, int senderIndex) {
+    Buffer& buffer = m_buffers[m_writeIndex];
+    buffer.messages.append(message);
+    buffer.senders.append(senderIndex);
+}
+
+void MessageArena::beginDelivery() {
+    if (m_senderOffsets.isEmpty()) {
+        m_senderOffsets.fill(0, m_vehicleCount + 1);
+    }
+    m_writeIndex = 1 - m_writeIndex;
+
+    // clear() conserve la capacité : pas de réallocation au pas suivant
+    Buffer& writeBuffer = m_buffers[m_writeIndex];
+    writeBuffer.messages.clear();
+    writeBuffer.senders.clear();
+    std::fill(m_inboxSizes.begin(), m_inboxSizes.end(), 0);
+
+    // Tri par comptage des messages par émetteur (ordre de publication conservé)
+    const Buffer& buffer = readBuffer();
+    std::fill(m_senderOffsets.begin(), m_senderOffsets.end(), 0);
+    for (int sender : buffer.senders) {
+        ++m_senderOffsets[sender + 1];
+    }
+    for (int v = 0; v < m_vehicleCount; ++v) {
+        m_senderOffsets[v + 1] += m_senderOffsets[v];
+    }
+    m_messagesBySender.resize(buffer.messages.size());
+    for (int m = 0; m < buffer.senders.size(); ++m) {
+        // m_senderOffsets[s] sert de curseur puis est restauré ci-dessous
+        m_messagesBySender[m_senderOffsets[buffer.senders.at(m)]++] = m;
+    }
+    for (int v = m_vehicleCount; v > 0; --v) {
+        m_senderOffsets[v] = m_senderOffsets[v - 1];
+    }
+    m_senderOffsets[0] = 0;
+}
+
+MessageIndexRange MessageArena::sentBy(int senderIndex) const {
+    if (senderIndex < 0 || senderIndex >= m_vehicleCount) return {};
+    const int* base = m_messagesBySender.constData();
+    return {base + m_senderOffsets.at(senderIndex), base + m_senderOffsets.at(senderIndex + 1)};
+}
+
+bool MessageArena::deliver(int vehicleIndex, int messageIndex) {
+    int& size = m_inboxSizes[vehicleIndex];
+    if (size >= m_inboxCapacity) {
+        m_droppedCams.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_inboxEntries[vehicleIndex * m_inboxCapacity + size++] = messageIndex;
+    return true;
+}
+
+MessageRange MessageArena::inbox(int vehicleIndex) const {
+    if (vehicleIndex < 0 || vehicleIndex >= m_vehicleCount) return {};
+    const int* entries = m_inboxEntries.constData() + vehicleIndex * m_inboxCapacity;
+    return {readBuffer().messages.constData(), entries, entries + m_inboxSizes.at(vehicleIndex)};
+}
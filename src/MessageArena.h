@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <atomic>
+
+#include "V2VMessage.h"
+
+// Vue sur la boîte de réception d'un véhicule : indices dans l'arène des messages
+struct MessageRange {
+    const V2VMessage* messages = nullptr;
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    struct iterator {
+        const V2VMessage* messages;
+        const int* current;
+        const V2VMessage& operator*() const { return messages[*current]; }
+        const V2VMessage* operator->() const { return &messages[*current]; }
+        iterator& operator++() { ++current; return *this; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+    };
+
+    iterator begin() const { return {messages, first}; }
+    iterator end() const { return {messages, last}; }
+    int size() const { return static_cast<int>(last - first); }
+    bool isEmpty() const { return first == last; }
+};
+
+// Vue sur les indices des messages diffusés par un même émetteur
+struct MessageIndexRange {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+    bool isEmpty() const { return first == last; }
+};
+
+// Arène des messages V2V, en double tampon, pour une messagerie en deux phases.
+//
+// Phase d'envoi : chaque diffusion est stockée une seule fois (post) dans le
+// tampon d'écriture, avec l'indice de son émetteur.
+// Phase de réception : beginDelivery() fige les messages postés (indexés par
+// émetteur) et vide les boîtes ; chaque récepteur tire ensuite les messages de
+// ses voisins à portée (deliver). Un récepteur n'écrit que dans sa propre
+// boîte, la phase de réception peut donc être parallèle.
+//
+// Les boîtes ne contiennent que des indices, dans un tableau plat de capacité
+// fixe par véhicule, et les tampons conservent leur mémoire d'un pas à l'autre :
+// en régime établi, la messagerie n'alloue plus.
+//
+// Boîte pleine : le message entrant est abandonné. L'arène ne transporte que
+// les CAM ; les alertes sont propagées à part (AlertPropagation).
+class MessageArena {
+public:
+    static constexpr int DEFAULT_INBOX_CAPACITY = 32;
+
+    void reset(int vehicleCount, int inboxCapacity = DEFAULT_INBOX_CAPACITY);
+    void clear();
+
+    int inboxCapacity() const { return m_inboxCapacity; }
+
+    // Phase d'envoi : stocke un message diffusé par senderIndex
+    void post(const V2VMessage& message, int senderIndex);
+    bool hasPendingMessages() const { return !m_buffers[m_writeIndex].messages.isEmpty(); }
+
+    // Phase de réception
+    void beginDelivery();
+    MessageIndexRange sentBy(int senderIndex) const;
+    // Ajoute le message messageIndex à la boîte du véhicule ; retourne false si
+    // la boîte est pleine
+    bool deliver(int vehicleIndex, int messageIndex);
+
+    // Messages reçus lors de la dernière phase de réception
+    MessageRange inbox(int vehicleIndex) const;
+
+    qint64 droppedCamCount() const { return m_droppedCams.load(std::memory_order_relaxed); }
+
+private:
+    struct Buffer {
+        QVector<V2VMessage> messages;
+        QVector<int> senders;       // Émetteur de chaque message
+    };
+
+    const Buffer& readBuffer() const { return m_buffers[1 - m_writeIndex]; }
+
+    Buffer m_buffers[2];
+    int m_writeIndex = 0;
+    int m_vehicleCount = 0;
+    int m_inboxCapacity = DEFAULT_INBOX_CAPACITY;
+
+    // Messages du tampon de lecture regroupés par émetteur (CSR)
+    QVector<int> m_senderOffsets;
+    QVector<int> m_messagesBySender;
+
+    QVector<int> m_inboxEntries;    // inboxCapacity indices par véhicule
+    QVector<int> m_inboxSizes;
+
+    std::atomic<qint64> m_droppedCams{0};
+};
@@ -0,0 +1,103 @@
+#include "NeighborGrid.h"
+
+#include "RoadGraph.h"
+
+void NeighborGrid::configure(const RoadGraph& graph, double maxRadius) {
+    clear();
+
+    const QVector<double>& nodeX = graph.nodeX();
+    const QVector<double>& nodeY = graph.nodeY();
+    if (nodeX.isEmpty()) return;
+
+    const auto [minX, maxX] = std::minmax_element(nodeX.constBegin(), nodeX.constEnd());
+    const auto [minY, maxY] = std::minmax_element(nodeY.constBegin(), nodeY.constEnd());
+    m_minX = *minX;
+    m_minY = *minY;
+
+    m_maxRadius = std::max(maxRadius, 0.0);
+    m_cellSize = std::max(2.0 * m_maxRadius, MIN_CELL_SIZE_METERS);
+
+    // Agrandir les cellules si l'emprise est trop vaste (graphe national, etc.)
+    const double width = *maxX - m_minX;
+    const double height = *maxY - m_minY;
+    while ((std::floor(width / m_cellSize) + 1) * (std::floor(height / m_cellSize) + 1) > MAX_CELL_COUNT) {
+        m_cellSize *= 2.0;
+    }
+    m_columns = static_cast<int>(std::floor(width / m_cellSize)) + 1;
+    m_rows = static_cast<int>(std::floor(height / m_cellSize)) + 1;
+    m_cellStart.fill(0, m_columns * m_rows + 1);
+}
+
+void NeighborGrid::update(const QVector<double>& xs, const QVector<double>& ys,
+                          const QVector<double>& radii) {
+    if (m_columns == 0) return;
+
+    const int count = xs.size();
+    bool cellsChanged = m_pointCell.size() != count;
+    m_pointCell.resize(count);
+    int* pointCell = m_pointCell.data();
+    for (int i = 0; i < count; ++i) {
+        const int cell = row(ys.at(i)) * m_columns + column(xs.at(i));
+        if (cell != pointCell[i]) {
+            pointCell[i] = cell;
+            cellsChanged = true;
+        }
+    }
+
+    if (cellsChanged) {
+        rebuildCells(xs, ys, radii);
+        return;
+    }
+
+    // Même répartition qu'au pas précédent : seules les positions sont rafraîchies
+    double* slotX = m_slotX.data();
+    double* slotY = m_slotY.data();
+    const int* slotPoint = m_slotPoint.constData();
+    for (int slot = 0; slot < count; ++slot) {
+        slotX[slot] = xs.at(slotPoint[slot]);
+        slotY[slot] = ys.at(slotPoint[slot]);
+    }
+}
+
+void NeighborGrid::rebuildCells(const QVector<double>& xs, const QVector<double>& ys,
+                                const QVector<double>& radii) {
+    const int count = xs.size();
+    const int cellCount = m_columns * m_rows;
+
+    // Tri par comptage : les points restent par indice croissant dans chaque cellule
+    m_cellStart.fill(0, cellCount + 1);
+    for (int cell : std::as_const(m_pointCell)) {
+        ++m_cellStart[cell + 1];
+    }
+    for (int c = 0; c < cellCount; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+
+    m_slotPoint.resize(count);
+    m_slotX.resize(count);
+    m_slotY.resize(count);
+    m_slotRadius.resize(count);
+    QVector<int> cursor(m_cellStart.constBegin(), m_cellStart.constEnd() - 1);
+    for (int i = 0; i < count; ++i) {
+        const int slot = cursor[m_pointCell.at(i)]++;
+        m_slotPoint[slot] = i;
+        m_slotX[slot] = xs.at(i);
+        m_slotY[slot] = ys.at(i);
+        m_slotRadius[slot] = radii.at(i);
+    }
+}
+
+void NeighborGrid::clear() {
+    m_minX = 0.0;
+    m_minY = 0.0;
+    m_cellSize = MIN_CELL_SIZE_METERS;
+    m_maxRadius = 0.0;
+    m_columns = 0;
+    m_rows = 0;
+    m_pointCell.clear();
+    m_cellStart.clear();
+    m_slotPoint.clear();
+    m_slotX.clear();
+    m_slotY.clear();
+    m_slotRadius.clear();
+}
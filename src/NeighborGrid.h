@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cmath>
+
+#include "Proximity.h"
+
+class RoadGraph;
+
+// Index spatial de points (grille uniforme, listes de cellules) dans le
+// repère métrique local du graphe. Les points sont rangés par cellule (tri par
+// comptage) avec une copie contiguë de leurs positions et portées, ce qui
+// permet d'appliquer Proximity::inRangeMask cellule par cellule.
+class NeighborGrid {
+public:
+    static constexpr double MIN_CELL_SIZE_METERS = 50.0;
+    static constexpr int MAX_CELL_COUNT = 1 << 22;
+
+    // Dimensionne la grille sur l'emprise du graphe. La taille de cellule vaut
+    // deux fois la plus grande portée : toute paire à portée est alors dans
+    // deux cellules voisines (3 x 3 cellules par requête).
+    void configure(const RoadGraph& graph, double maxRadius);
+    // Recalcule la cellule de chaque point ; les listes ne sont reconstruites
+    // que si au moins un point a changé de cellule.
+    void update(const QVector<double>& xs, const QVector<double>& ys, const QVector<double>& radii);
+    void clear();
+
+    double cellSize() const { return m_cellSize; }
+    // Indices des points rangés cellule par cellule
+    const QVector<int>& pointsByCell() const { return m_slotPoint; }
+
+    // Appelle visit(index) pour chaque point autre que excludeIndex situé à
+    // portée d'un émetteur en (x, y) de portée radius : distance <= radius + r_j.
+    template <typename Visitor>
+    void forEachInRange(double x, double y, double radius, int excludeIndex, Visitor&& visit) const {
+        if (m_columns == 0) return;
+
+        const double reach = radius + m_maxRadius;
+        const int colMin = column(x - reach);
+        const int colMax = column(x + reach);
+        const int rowMin = row(y - reach);
+        const int rowMax = row(y + reach);
+
+        for (int r = rowMin; r <= rowMax; ++r) {
+            for (int c = colMin; c <= colMax; ++c) {
+                const int cell = r * m_columns + c;
+                const int cellEnd = m_cellStart.at(cell + 1);
+                for (int slot = m_cellStart.at(cell); slot < cellEnd; slot += Proximity::BLOCK_SIZE) {
+                    const int count = std::min(Proximity::BLOCK_SIZE, cellEnd - slot);
+                    quint64 mask = Proximity::inRangeMask(x, y, radius,
+                                                          m_slotX.constData() + slot,
+                                                          m_slotY.constData() + slot,
+                                                          m_slotRadius.constData() + slot,
+                                                          count);
+                    while (mask != 0) {
+                        const int bit = qCountTrailingZeroBits(mask);
+                        mask &= mask - 1;
+                        const int other = m_slotPoint.at(slot + bit);
+                        if (other != excludeIndex) {
+                            visit(other);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    int column(double x) const {
+        return std::clamp(static_cast<int>(std::floor((x - m_minX) / m_cellSize)), 0, m_columns - 1);
+    }
+    int row(double y) const {
+        return std::clamp(static_cast<int>(std::floor((y - m_minY) / m_cellSize)), 0, m_rows - 1);
+    }
+    void rebuildCells(const QVector<double>& xs, const QVector<double>& ys, const QVector<double>& radii);
+
+    double m_minX = 0.0;
+    double m_minY = 0.0;
+    double m_cellSize = MIN_CELL_SIZE_METERS;
+    double m_maxRadius = 0.0;
+    int m_columns = 0;
+    int m_rows = 0;
+
+    QVector<int> m_pointCell;       // Cellule courante de chaque point
+    QVector<int> m_cellStart;       // Les points de la cellule c occupent [start[c], start[c + 1])
+    QVector<int> m_slotPoint;       // Indice du point, rangé par cellule
+    QVector<double> m_slotX;        // Positions et portées recopiées dans l'ordre des cellules
+    QVector<double> m_slotY;
+    QVector<double> m_slotRadius;
+};
@@ -0,0 +1,92 @@
+#include "NeighborLists.h"
+
+#include "RoadGraph.h"
+
+void NeighborLists::build(const RoadGraph& graph, const VehicleStore& vehicles) {
+    clear();
+
+    const QVector<double>& radii = vehicles.transmissionRadii();
+    const double maxRadius = radii.isEmpty() ? 0.0 : *std::max_element(radii.constBegin(), radii.constEnd());
+    m_grid.configure(graph, maxRadius);
+
+    m_refX = vehicles.positionsX();
+    m_refY = vehicles.positionsY();
+    m_grid.update(m_refX, m_refY, radii);
+
+    // La condition de portée étant symétrique, les listes le sont d'emblée
+    m_lists.resize(vehicles.size());
+    for (int i = 0; i < vehicles.size(); ++i) {
+        QVector<int>& list = m_lists[i];
+        m_grid.forEachInRange(m_refX.at(i), m_refY.at(i), radii.at(i) + m_skin, i,
+                              [&list](int other) { list.append(other); });
+    }
+    m_rebuildCount = vehicles.size();
+    m_lastUpdateRebuildCount = vehicles.size();
+}
+
+void NeighborLists::update(const VehicleStore& vehicles) {
+    m_lastUpdateRebuildCount = 0;
+    if (m_lists.size() != vehicles.size()) return;
+
+    const double* xs = vehicles.positionsX().constData();
+    const double* ys = vehicles.positionsY().constData();
+    const double halfSkinSquared = 0.25 * m_skin * m_skin;
+
+    // 1. Véhicules sortis de leur demi-peau : nouvelle position de référence
+    m_staleVehicles.clear();
+    for (int i = 0; i < vehicles.size(); ++i) {
+        const double dx = xs[i] - m_refX.at(i);
+        const double dy = ys[i] - m_refY.at(i);
+        if (dx * dx + dy * dy > halfSkinSquared) {
+            m_staleVehicles.append(i);
+            m_refX[i] = xs[i];
+            m_refY[i] = ys[i];
+        }
+    }
+    if (m_staleVehicles.isEmpty()) return;
+
+    // 2. Index des références à jour, puis reconstruction des listes concernées
+    m_grid.update(m_refX, m_refY, vehicles.transmissionRadii());
+    for (int vehicleIndex : std::as_const(m_staleVehicles)) {
+        rebuildList(vehicleIndex, vehicles);
+    }
+
+    m_lastUpdateRebuildCount = m_staleVehicles.size();
+    m_rebuildCount += m_staleVehicles.size();
+}
+
+void NeighborLists::rebuildList(int vehicleIndex, const VehicleStore& vehicles) {
+    QVector<int>& list = m_lists[vehicleIndex];
+
+    // Retirer le véhicule des listes de ses anciens voisins
+    for (int other : std::as_const(list)) {
+        removeFrom(m_lists[other], vehicleIndex);
+    }
+    list.clear();
+
+    // Nouveaux voisins autour de la référence, symétrie rétablie au passage
+    m_grid.forEachInRange(m_refX.at(vehicleIndex), m_refY.at(vehicleIndex),
+                          vehicles.transmissionRadii().at(vehicleIndex) + m_skin, vehicleIndex,
+                          [this, &list, vehicleIndex](int other) {
+        list.append(other);
+        m_lists[other].append(vehicleIndex);
+    });
+}
+
+void NeighborLists::removeFrom(QVector<int>& list, int vehicleIndex) {
+    // L'ordre des listes n'a pas d'importance : retrait par échange avec le dernier
+    const int position = list.indexOf(vehicleIndex);
+    if (position < 0) return;
+    list[position] = list.last();
+    list.removeLast();
+}
+
+void NeighborLists::clear() {
+    m_grid.clear();
+    m_refX.clear();
+    m_refY.clear();
+    m_lists.clear();
+    m_staleVehicles.clear();
+    m_rebuildCount = 0;
+    m_lastUpdateRebuildCount = 0;
+}
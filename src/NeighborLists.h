@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+#include "NeighborGrid.h"
+#include "Proximity.h"
+#include "VehicleStore.h"
+
+class RoadGraph;
+
+// Listes de voisins candidats par véhicule (listes de Verlet), réutilisées
+// d'un pas à l'autre.
+//
+// Chaque véhicule i a une position de référence ref_i, fixée à la dernière
+// reconstruction de sa liste. Sa liste contient les véhicules j tels que
+// |ref_i - ref_j| <= r_i + r_j + skin, et elle est symétrique (j est dans la
+// liste de i si et seulement si i est dans celle de j). Dès qu'un véhicule
+// s'éloigne de plus de skin / 2 de sa référence, sa liste est reconstruite
+// (et il est retiré puis réinséré dans celles de ses voisins). Tant que
+// chaque véhicule reste à moins de skin / 2 de sa référence, toute paire à
+// portée radio figure donc dans les listes.
+class NeighborLists {
+public:
+    static constexpr double DEFAULT_SKIN_METERS = 50.0;
+
+    void setSkin(double meters) { m_skin = std::max(meters, 0.0); }
+    double skin() const { return m_skin; }
+
+    // Construit toutes les listes à partir des positions courantes
+    void build(const RoadGraph& graph, const VehicleStore& vehicles);
+    // Reconstruit les listes des véhicules ayant dépassé skin / 2 (une fois par pas)
+    void update(const VehicleStore& vehicles);
+    void clear();
+
+    // Nombre de listes reconstruites depuis build() et au dernier update()
+    qint64 rebuildCount() const { return m_rebuildCount; }
+    int lastUpdateRebuildCount() const { return m_lastUpdateRebuildCount; }
+
+    const QVector<int>& candidates(int vehicleIndex) const { return m_lists.at(vehicleIndex); }
+    // Véhicules rangés par cellule de la grille (références), pour un parcours local
+    const QVector<int>& vehiclesByCell() const { return m_grid.pointsByCell(); }
+
+    // Appelle visit(index) pour chaque véhicule à portée radio du véhicule
+    // vehicleIndex (positions courantes) : distance <= r_i + r_j.
+    template <typename Visitor>
+    void forEachInRange(int vehicleIndex, const VehicleStore& vehicles, Visitor&& visit) const {
+        const QVector<int>& list = m_lists.at(vehicleIndex);
+        const double* xs = vehicles.positionsX().constData();
+        const double* ys = vehicles.positionsY().constData();
+        const double* radii = vehicles.transmissionRadii().constData();
+
+        // Regroupement des candidats par blocs contigus pour le test vectorisé
+        double blockX[Proximity::BLOCK_SIZE];
+        double blockY[Proximity::BLOCK_SIZE];
+        double blockRadius[Proximity::BLOCK_SIZE];
+        for (int first = 0; first < list.size(); first += Proximity::BLOCK_SIZE) {
+            const int count = std::min(Proximity::BLOCK_SIZE, static_cast<int>(list.size()) - first);
+            const int* block = list.constData() + first;
+            for (int k = 0; k < count; ++k) {
+                blockX[k] = xs[block[k]];
+                blockY[k] = ys[block[k]];
+                blockRadius[k] = radii[block[k]];
+            }
+
+            quint64 mask = Proximity::inRangeMask(xs[vehicleIndex], ys[vehicleIndex], radii[vehicleIndex],
+                                                  blockX, blockY, blockRadius, count);
+            while (mask != 0) {
+                const int bit = qCountTrailingZeroBits(mask);
+                mask &= mask - 1;
+                visit(block[bit]);
+            }
+        }
+    }
+
+private:
+    void rebuildList(int vehicleIndex, const VehicleStore& vehicles);
+    static void removeFrom(QVector<int>& list, int vehicleIndex);
+
+    double m_skin = DEFAULT_SKIN_METERS;
+    NeighborGrid m_grid;                // Index des positions de référence
+    QVector<double> m_refX;
+    QVector<double> m_refY;
+    QVector<QVector<int>> m_lists;
+    QVector<int> m_staleVehicles;       // Tampon réutilisé par update()
+    qint64 m_rebuildCount = 0;
+    int m_lastUpdateRebuildCount = 0;
+};
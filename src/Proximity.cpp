@@ -0,0 +1,56 @@
+#include "Proximity.h"
+
+#include <QtMath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define V2V_PROXIMITY_SSE2
+#endif
+
+double Proximity::haversineMeters(double lat1, double lon1, double lat2, double lon2) {
+    static constexpr double earthRadiusMeters = 6371000.0;
+    double lat1Rad = qDegreesToRadians(lat1);
+    double lon1Rad = qDegreesToRadians(lon1);
+    double lat2Rad = qDegreesToRadians(lat2);
+    double lon2Rad = qDegreesToRadians(lon2);
+    double dlat = lat2Rad - lat1Rad;
+    double dlon = lon2Rad - lon1Rad;
+    double a = qSin(dlat / 2) * qSin(dlat / 2) +
+               qCos(lat1Rad) * qCos(lat2Rad) * qSin(dlon / 2) * qSin(dlon / 2);
+    double c = 2 * qAtan2(qSqrt(a), qSqrt(1 - a));
+    return earthRadiusMeters * c;
+}
+
+quint64 Proximity::inRangeMask(double senderX, double senderY, double senderRadius,
+                               const double* xs, const double* ys, const double* radii,
+                               int count) {
+    if (count > BLOCK_SIZE) count = BLOCK_SIZE;
+
+    quint64 mask = 0;
+    int i = 0;
+
+#ifdef V2V_PROXIMITY_SSE2
+    // Deux récepteurs par itération : dx² + dy² <= (r_s + r_i)²
+    const __m128d sx = _mm_set1_pd(senderX);
+    const __m128d sy = _mm_set1_pd(senderY);
+    const __m128d sr = _mm_set1_pd(senderRadius);
+    for (; i + 2 <= count; i += 2) {
+        const __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), sx);
+        const __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), sy);
+        const __m128d range = _mm_add_pd(_mm_loadu_pd(radii + i), sr);
+        const __m128d distanceSquared = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        const int bits = _mm_movemask_pd(_mm_cmple_pd(distanceSquared, _mm_mul_pd(range, range)));
+        mask |= static_cast<quint64>(bits) << i;
+    }
+#endif
+
+    // Reliquat (ou chemin portable) : boucle sans branchement, vectorisable
+    for (; i < count; ++i) {
+        const double dx = xs[i] - senderX;
+        const double dy = ys[i] - senderY;
+        const double range = radii[i] + senderRadius;
+        mask |= static_cast<quint64>(dx * dx + dy * dy <= range * range) << i;
+    }
+
+    return mask;
+}
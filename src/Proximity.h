@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Calculs de distance partagés par le chargement du graphe et la simulation.
+class Proximity {
+public:
+    // Nombre maximal de récepteurs testés par appel à inRangeMask (un bit chacun)
+    static constexpr int BLOCK_SIZE = 64;
+
+    // Distance orthodromique (formule de haversine), en mètres
+    static double haversineMeters(double lat1, double lon1, double lat2, double lon2);
+
+    // Teste un émetteur contre un bloc de récepteurs candidats, positions dans
+    // le repère métrique local du graphe. Le bit i du résultat vaut 1 si le
+    // récepteur i est à portée : distance <= senderRadius + radii[i].
+    // count est borné à BLOCK_SIZE. Pour des portées de quelques centaines de
+    // mètres, l'écart avec haversineMeters() est négligeable (< 0,1 %).
+    static quint64 inRangeMask(double senderX, double senderY, double senderRadius,
+                               const double* xs, const double* ys, const double* radii,
+                               int count);
+};
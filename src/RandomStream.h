@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Générateur pseudo-aléatoire à compteur (SplitMix64) : 8 octets d'état,
+// aucune allocation ni appel système. Chaque flux est dérivé d'un couple
+// (graine du scénario, identifiant de flux), ce qui rend la simulation
+// reproductible à l'identique pour une même graine.
+class RandomStream {
+public:
+    RandomStream() = default;
+    explicit RandomStream(quint64 state) : m_state(state) {}
+
+    static RandomStream forStream(quint64 seed, quint64 streamId) {
+        return RandomStream(mix(seed ^ mix(streamId + GOLDEN_GAMMA)));
+    }
+
+    quint64 next() {
+        m_state += GOLDEN_GAMMA;
+        return mix(m_state);
+    }
+
+    // Réel uniforme dans [0, 1) (53 bits de mantisse)
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+    double uniform(double min, double max) { return min + (max - min) * uniform(); }
+
+    // Entier uniforme dans [0, bound) sans division (multiplication 32x32 -> 64 bits)
+    int bounded(int bound) {
+        if (bound <= 1) return 0;
+        return static_cast<int>(((next() >> 32) * static_cast<quint64>(bound)) >> 32);
+    }
+
+    bool coin() { return (next() >> 63) != 0; }
+
+    quint64 state() const { return m_state; }
+
+private:
+    static constexpr quint64 GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    static quint64 mix(quint64 z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    quint64 m_state = 0;
+};
@@ -1,50 +1,599 @@
 #include "RoadGraph.h"
 
+#include <QPair>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+template <typename T, typename IdOf>
+QVector<IdIndexEntry> sortedIdTable(const QVector<T>& elements, IdOf idOf) {
+    QVector<IdIndexEntry> table(elements.size());
+    for (int i = 0; i < elements.size(); ++i) {
+        table[i].id = idOf(elements.at(i));
+        table[i].index = i;
+    }
+    std::sort(table.begin(), table.end(),
+              [](const IdIndexEntry& a, const IdIndexEntry& b) { return a.id < b.id; });
+    return table;
+}
+
+QHash<qint64, int> hashedIdTable(const QVector<IdIndexEntry>& table) {
+    QHash<qint64, int> hash;
+    hash.reserve(table.size());
+    for (const IdIndexEntry& entry : table) {
+        hash.insert(entry.id, entry.index);
+    }
+    return hash;
+}
+
+int findInIdTable(const QVector<IdIndexEntry>& table, qint64 id) {
+    auto it = std::lower_bound(table.cbegin(), table.cend(), id,
+                               [](const IdIndexEntry& entry, qint64 value) { return entry.id < value; });
+    return it != table.cend() && it->id == id ? it->index : -1;
+}
+} // namespace
+
 int RoadGraph::addNode(const RoadNode& node) {
+    unsortIdIndex();
     if (m_nodeIndexById.contains(node.id)) {
         return m_nodeIndexById.value(node.id);
     }
     int index = m_nodes.size();
     m_nodes.append(node);
+    m_adjacencyBuilt = false;
+    m_geometryBuilt = false;
     m_nodeIndexById.insert(node.id, index);
     return index;
 }
 
 int RoadGraph::addEdge(const RoadEdge& edge) {
+    unsortIdIndex();
     if (m_edgeIndexById.contains(edge.id)) {
         return m_edgeIndexById.value(edge.id);
     }
-    if (edge.fromNode >= 0 && edge.fromNode < m_nodes.size()) {
-        m_nodes[edge.fromNode].outgoingEdges.append(m_edges.size());
-    }
     int index = m_edges.size();
     m_edges.append(edge);
+    m_adjacencyBuilt = false;
+    m_geometryBuilt = false;
     m_edgeIndexById.insert(edge.id, index);
     return index;
 }
 
+int RoadGraph::addWayAttributes(const WayAttributes& attributes) {
+    unsortIdIndex();
+    auto it = m_wayAttributeIndexById.constFind(attributes.wayId);
+    if (it != m_wayAttributeIndexById.constEnd()) {
+        return it.value();
+    }
+    int index = m_wayAttributes.size();
+    m_wayAttributes.append(attributes);
+    m_wayAttributeIndexById.insert(attributes.wayId, index);
+    return index;
+}
+
+const WayAttributes& RoadGraph::edgeAttributes(int edgeIndex) const {
+    static const WayAttributes defaultAttributes;
+    if (edgeIndex < 0 || edgeIndex >= m_edges.size()) return defaultAttributes;
+    int attributeIndex = m_edges.at(edgeIndex).attributeIndex;
+    if (attributeIndex < 0 || attributeIndex >= m_wayAttributes.size()) return defaultAttributes;
+    return m_wayAttributes.at(attributeIndex);
+}
+
 const RoadNode* RoadGraph::nodeById(qint64 osmId) const {
-    auto it = m_nodeIndexById.constFind(osmId);
-    if (it == m_nodeIndexById.constEnd()) return nullptr;
-    return &m_nodes.at(it.value());
+    const int index = nodeIndex(osmId);
+    return index >= 0 ? &m_nodes.at(index) : nullptr;
 }
 
 const RoadEdge* RoadGraph::edgeById(qint64 osmId) const {
-    auto it = m_edgeIndexById.constFind(osmId);
-    if (it == m_edgeIndexById.constEnd()) return nullptr;
-    return &m_edges.at(it.value());
+    const int index = m_idIndexSorted ? findInIdTable(m_sortedEdgeIds, osmId) : m_edgeIndexById.value(osmId, -1);
+    return index >= 0 ? &m_edges.at(index) : nullptr;
 }
 
 int RoadGraph::nodeIndex(qint64 osmId) const {
-    auto it = m_nodeIndexById.constFind(osmId);
-    if (it == m_nodeIndexById.constEnd()) return -1;
-    return it.value();
+    return m_idIndexSorted ? findInIdTable(m_sortedNodeIds, osmId) : m_nodeIndexById.value(osmId, -1);
+}
+
+void RoadGraph::sortIdIndex() {
+    if (m_idIndexSorted) return;
+    m_sortedNodeIds = sortedIdTable(m_nodes, [](const RoadNode& node) { return node.id; });
+    m_sortedEdgeIds = sortedIdTable(m_edges, [](const RoadEdge& edge) { return edge.id; });
+    m_sortedWayAttributeIds = sortedIdTable(m_wayAttributes, [](const WayAttributes& way) { return way.wayId; });
+    m_nodeIndexById.clear();
+    m_edgeIndexById.clear();
+    m_wayAttributeIndexById.clear();
+    m_idIndexSorted = true;
+}
+
+void RoadGraph::unsortIdIndex() {
+    // Modification d'un graphe terminé : retour aux tables de hachage
+    if (!m_idIndexSorted) return;
+    m_nodeIndexById = hashedIdTable(m_sortedNodeIds);
+    m_edgeIndexById = hashedIdTable(m_sortedEdgeIds);
+    m_wayAttributeIndexById = hashedIdTable(m_sortedWayAttributeIds);
+    m_sortedNodeIds.clear();
+    m_sortedEdgeIds.clear();
+    m_sortedWayAttributeIds.clear();
+    m_idIndexSorted = false;
+}
+
+void RoadGraph::buildAdjacency() {
+    const int nodeCount = m_nodes.size();
+    m_outgoingOffsets.fill(0, nodeCount + 1);
+    m_incomingOffsets.fill(0, nodeCount + 1);
+
+    // Comptage des degrés (les arêtes invalides sont ignorées)
+    for (const RoadEdge& edge : std::as_const(m_edges)) {
+        if (edge.fromNode < 0 || edge.toNode < 0 ||
+            edge.fromNode >= nodeCount || edge.toNode >= nodeCount) {
+            continue;
+        }
+        ++m_outgoingOffsets[edge.fromNode + 1];
+        ++m_incomingOffsets[edge.toNode + 1];
+    }
+    for (int n = 0; n < nodeCount; ++n) {
+        m_outgoingOffsets[n + 1] += m_outgoingOffsets[n];
+        m_incomingOffsets[n + 1] += m_incomingOffsets[n];
+    }
+
+    // Remplissage : les arêtes restent triées par indice au sein de chaque nœud
+    m_outgoingEdges.resize(m_outgoingOffsets[nodeCount]);
+    m_incomingEdges.resize(m_incomingOffsets[nodeCount]);
+    QVector<int> outCursor(m_outgoingOffsets.constBegin(), m_outgoingOffsets.constEnd() - 1);
+    QVector<int> inCursor(m_incomingOffsets.constBegin(), m_incomingOffsets.constEnd() - 1);
+    for (int i = 0; i < m_edges.size(); ++i) {
+        const RoadEdge& edge = m_edges.at(i);
+        if (edge.fromNode < 0 || edge.toNode < 0 ||
+            edge.fromNode >= nodeCount || edge.toNode >= nodeCount) {
+            continue;
+        }
+        m_outgoingEdges[outCursor[edge.fromNode]++] = i;
+        m_incomingEdges[inCursor[edge.toNode]++] = i;
+    }
+
+    m_adjacencyBuilt = true;
+    sortIdIndex();
+}
+
+EdgeIndexRange RoadGraph::outgoingEdges(int nodeIndex) const {
+    if (!m_adjacencyBuilt || nodeIndex < 0 || nodeIndex >= m_nodes.size()) return {};
+    const int* base = m_outgoingEdges.constData();
+    return {base + m_outgoingOffsets.at(nodeIndex), base + m_outgoingOffsets.at(nodeIndex + 1)};
+}
+
+EdgeIndexRange RoadGraph::incomingEdges(int nodeIndex) const {
+    if (!m_adjacencyBuilt || nodeIndex < 0 || nodeIndex >= m_nodes.size()) return {};
+    const int* base = m_incomingEdges.constData();
+    return {base + m_incomingOffsets.at(nodeIndex), base + m_incomingOffsets.at(nodeIndex + 1)};
+}
+
+namespace {
+struct HighwayClassName {
+    const char* name;
+    HighwayClass highwayClass;
+};
+
+constexpr HighwayClassName HIGHWAY_CLASS_NAMES[] = {
+    {"motorway", HighwayClass::Motorway},
+    {"motorway_link", HighwayClass::MotorwayLink},
+    {"trunk", HighwayClass::Trunk},
+    {"trunk_link", HighwayClass::TrunkLink},
+    {"primary", HighwayClass::Primary},
+    {"primary_link", HighwayClass::PrimaryLink},
+    {"secondary", HighwayClass::Secondary},
+    {"secondary_link", HighwayClass::SecondaryLink},
+    {"tertiary", HighwayClass::Tertiary},
+    {"tertiary_link", HighwayClass::TertiaryLink},
+    {"residential", HighwayClass::Residential},
+    {"unclassified", HighwayClass::Unclassified},
+    {"living_street", HighwayClass::LivingStreet},
+    {"service", HighwayClass::Service},
+};
+} // namespace
+
+HighwayClass highwayClassFromName(QAnyStringView name) {
+    for (const HighwayClassName& entry : HIGHWAY_CLASS_NAMES) {
+        if (name == QLatin1String(entry.name)) return entry.highwayClass;
+    }
+    return HighwayClass::Unsupported;
+}
+
+QString highwayClassName(HighwayClass highwayClass) {
+    for (const HighwayClassName& entry : HIGHWAY_CLASS_NAMES) {
+        if (entry.highwayClass == highwayClass) return QString::fromLatin1(entry.name);
+    }
+    return QString();
+}
+
+int RoadGraph::contractDegreeTwoChains() {
+    unsortIdIndex();
+    const int nodeCount = m_nodes.size();
+    const int edgeCount = m_edges.size();
+
+    // Incidence (arêtes valides uniquement)
+    QVector<QVector<int>> incident(nodeCount);
+    QVector<bool> used(edgeCount, true);
+    for (int e = 0; e < edgeCount; ++e) {
+        const RoadEdge& edge = m_edges.at(e);
+        if (edge.fromNode < 0 || edge.toNode < 0 || edge.fromNode >= nodeCount || edge.toNode >= nodeCount) {
+            continue;
+        }
+        used[e] = false;
+        incident[edge.fromNode].append(e);
+        if (edge.toNode != edge.fromNode) {
+            incident[edge.toNode].append(e);
+        }
+    }
+
+    auto otherEnd = [this](int edgeIndex, int node) {
+        const RoadEdge& edge = m_edges.at(edgeIndex);
+        return edge.fromNode == node ? edge.toNode : edge.fromNode;
+    };
+    auto sameAttributes = [this](int a, int b) {
+        const WayAttributes& first = edgeAttributes(a);
+        const WayAttributes& second = edgeAttributes(b);
+        return first.highwayClass == second.highwayClass && first.maxSpeedKmh == second.maxSpeedKmh &&
+               first.oneway == second.oneway;
+    };
+
+    // Nœud intérieur : exactement deux voisins, attributs identiques, autant
+    // d'arêtes de chaque côté et, en sens unique, chaque entrée prolongée par une sortie
+    QVector<bool> interior(nodeCount, false);
+    for (int v = 0; v < nodeCount; ++v) {
+        const QVector<int>& edges = incident.at(v);
+        if (edges.size() < 2) continue;
+        int sideA = -1;
+        int sideB = -1;
+        int countA = 0;
+        int countB = 0;
+        int inFromA = 0;
+        int outToB = 0;
+        int inFromB = 0;
+        int outToA = 0;
+        bool valid = true;
+        for (int e : edges) {
+            const int neighbor = otherEnd(e, v);
+            if (neighbor == v || !sameAttributes(e, edges.first())) {
+                valid = false;
+                break;
+            }
+            if (sideA < 0 || neighbor == sideA) {
+                sideA = neighbor;
+                ++countA;
+                (m_edges.at(e).toNode == v ? inFromA : outToA)++;
+            } else if (sideB < 0 || neighbor == sideB) {
+                sideB = neighbor;
+                ++countB;
+                (m_edges.at(e).toNode == v ? inFromB : outToB)++;
+            } else {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid || sideB < 0 || countA != countB) continue;
+        if (edgeAttributes(edges.first()).oneway && (inFromA != outToB || inFromB != outToA)) continue;
+        interior[v] = true;
+    }
+
+    QVector<RoadEdge> mergedEdges;
+    QVector<RoadNode> shapePoints;
+    mergedEdges.reserve(edgeCount);
+
+    // Parcourt une chaîne depuis start par l'arête first jusqu'au prochain nœud non
+    // intérieur. Le parcours suit les pièces orientées comme first et l'arête
+    // fusionnée prend leur sens : une voie à double sens stockée en deux arêtes
+    // orientées par segment donne une arête fusionnée par sens, et non deux
+    // arêtes dans le même sens.
+    auto walkChain = [&](int start, int first) {
+        RoadEdge merged = m_edges.at(first);
+        merged.fromNode = start;
+        merged.lengthMeters = 0.0;
+        merged.shapeBegin = shapePoints.size();
+        const bool oneway = edgeAttributes(first).oneway;
+        const bool alongPieces = m_edges.at(first).fromNode == start;
+
+        int node = start;
+        int edgeIndex = first;
+        while (true) {
+            used[edgeIndex] = true;
+            const RoadEdge& piece = m_edges.at(edgeIndex);
+            merged.lengthMeters += piece.lengthMeters;
+            // Points de forme déjà présents sur la pièce, dans le sens de parcours
+            if (piece.fromNode == node) {
+                for (int k = piece.shapeBegin; k < piece.shapeEnd; ++k) shapePoints.append(m_shapePoints.at(k));
+            } else {
+                for (int k = piece.shapeEnd - 1; k >= piece.shapeBegin; --k) shapePoints.append(m_shapePoints.at(k));
+            }
+
+            const int previous = node;
+            node = otherEnd(edgeIndex, node);
+            if (!interior.at(node)) break;
+            shapePoints.append(m_nodes.at(node));
+
+            // Arête suivante vers l'autre voisin, de préférence orientée comme first
+            int next = -1;
+            for (int candidate : incident.at(node)) {
+                if (used.at(candidate) || otherEnd(candidate, node) == previous) continue;
+                const bool continues = (m_edges.at(candidate).fromNode == node) == alongPieces;
+                if (oneway && !continues) continue;
+                if (next < 0 || (continues && (m_edges.at(next).fromNode == node) != alongPieces)) next = candidate;
+            }
+            if (next < 0) break; // Ne devrait pas arriver : nœud intérieur équilibré
+            edgeIndex = next;
+        }
+
+        merged.toNode = node;
+        merged.shapeEnd = shapePoints.size();
+        if (!alongPieces) {
+            // Pièces parcourues à rebours : l'arête fusionnée est retournée
+            std::swap(merged.fromNode, merged.toNode);
+            std::reverse(shapePoints.begin() + merged.shapeBegin, shapePoints.end());
+        }
+        mergedEdges.append(merged);
+    };
+
+    auto walkFrom = [&](int start) {
+        for (int e : incident.at(start)) {
+            if (used.at(e)) continue;
+            // Une arête en sens unique ne se parcourt que depuis son origine
+            if (m_edges.at(e).fromNode != start && edgeAttributes(e).oneway) continue;
+            walkChain(start, e);
+        }
+    };
+
+    for (int v = 0; v < nodeCount; ++v) {
+        if (!interior.at(v)) walkFrom(v);
+    }
+    // Boucles fermées de nœuds intérieurs : un nœud de chaque boucle est conservé
+    for (int e = 0; e < edgeCount; ++e) {
+        if (used.at(e)) continue;
+        const int anchor = m_edges.at(e).fromNode;
+        interior[anchor] = false;
+        walkFrom(anchor);
+    }
+
+    // Renumérotation des nœuds conservés
+    QVector<int> newIndex(nodeCount, -1);
+    QVector<RoadNode> keptNodes;
+    for (int v = 0; v < nodeCount; ++v) {
+        if (interior.at(v)) continue;
+        newIndex[v] = keptNodes.size();
+        keptNodes.append(m_nodes.at(v));
+    }
+    for (RoadEdge& edge : mergedEdges) {
+        edge.fromNode = newIndex.at(edge.fromNode);
+        edge.toNode = newIndex.at(edge.toNode);
+    }
+
+    const int removedEdges = edgeCount - mergedEdges.size();
+    m_nodes = keptNodes;
+    m_edges = mergedEdges;
+    m_shapePoints = shapePoints;
+    m_nodeIndexById.clear();
+    for (int n = 0; n < m_nodes.size(); ++n) {
+        m_nodeIndexById.insert(m_nodes.at(n).id, n);
+    }
+    m_edgeIndexById.clear();
+    for (int e = 0; e < m_edges.size(); ++e) {
+        m_edgeIndexById.insert(m_edges.at(e).id, e);
+    }
+    m_adjacencyBuilt = false;
+    m_geometryBuilt = false;
+    return removedEdges;
+}
+
+namespace {
+// Indice sur la courbe de Hilbert d'ordre 16 du point (x, y) de la grille 65536 × 65536
+quint64 hilbertIndex(quint32 x, quint32 y) {
+    quint64 index = 0;
+    for (quint32 s = 1u << 15; s > 0; s >>= 1) {
+        const quint32 rx = (x & s) ? 1 : 0;
+        const quint32 ry = (y & s) ? 1 : 0;
+        index += static_cast<quint64>(s) * s * ((3 * rx) ^ ry);
+        // Rotation du quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+} // namespace
+
+void RoadGraph::reorderForLocality() {
+    unsortIdIndex();
+    const int nodeCount = m_nodes.size();
+    if (nodeCount == 0) return;
+
+    // Clés de Hilbert sur l'emprise des nœuds
+    double minLat = m_nodes.at(0).lat, maxLat = minLat;
+    double minLon = m_nodes.at(0).lon, maxLon = minLon;
+    for (const RoadNode& node : std::as_const(m_nodes)) {
+        minLat = std::min(minLat, node.lat);
+        maxLat = std::max(maxLat, node.lat);
+        minLon = std::min(minLon, node.lon);
+        maxLon = std::max(maxLon, node.lon);
+    }
+    const double scaleLat = maxLat > minLat ? 65535.0 / (maxLat - minLat) : 0.0;
+    const double scaleLon = maxLon > minLon ? 65535.0 / (maxLon - minLon) : 0.0;
+
+    QVector<QPair<quint64, int>> nodeOrder(nodeCount);
+    for (int n = 0; n < nodeCount; ++n) {
+        const RoadNode& node = m_nodes.at(n);
+        const quint32 x = static_cast<quint32>((node.lon - minLon) * scaleLon);
+        const quint32 y = static_cast<quint32>((node.lat - minLat) * scaleLat);
+        nodeOrder[n] = qMakePair(hilbertIndex(x, y), n);
+    }
+    std::sort(nodeOrder.begin(), nodeOrder.end());
+
+    QVector<int> newNodeIndex(nodeCount);
+    QVector<RoadNode> nodes(nodeCount);
+    for (int n = 0; n < nodeCount; ++n) {
+        newNodeIndex[nodeOrder.at(n).second] = n;
+        nodes[n] = m_nodes.at(nodeOrder.at(n).second);
+    }
+
+    // Arêtes triées par nouveau nœud d'origine puis de destination ; les points
+    // de forme suivent l'ordre des arêtes
+    auto remap = [&](int node) { return node >= 0 && node < nodeCount ? newNodeIndex.at(node) : node; };
+    QVector<int> edgeOrder(m_edges.size());
+    for (int e = 0; e < m_edges.size(); ++e) {
+        edgeOrder[e] = e;
+    }
+    std::stable_sort(edgeOrder.begin(), edgeOrder.end(), [&](int a, int b) {
+        const RoadEdge& first = m_edges.at(a);
+        const RoadEdge& second = m_edges.at(b);
+        return qMakePair(remap(first.fromNode), remap(first.toNode)) <
+               qMakePair(remap(second.fromNode), remap(second.toNode));
+    });
+
+    QVector<RoadEdge> edges;
+    QVector<RoadNode> shapePoints;
+    edges.reserve(m_edges.size());
+    shapePoints.reserve(m_shapePoints.size());
+    for (int oldIndex : std::as_const(edgeOrder)) {
+        RoadEdge edge = m_edges.at(oldIndex);
+        edge.fromNode = remap(edge.fromNode);
+        edge.toNode = remap(edge.toNode);
+        const int shapeBegin = shapePoints.size();
+        for (int k = edge.shapeBegin; k < edge.shapeEnd; ++k) {
+            shapePoints.append(m_shapePoints.at(k));
+        }
+        edge.shapeBegin = shapeBegin;
+        edge.shapeEnd = shapePoints.size();
+        edges.append(edge);
+    }
+
+    m_nodes = nodes;
+    m_edges = edges;
+    m_shapePoints = shapePoints;
+    m_nodeIndexById.clear();
+    for (int n = 0; n < m_nodes.size(); ++n) {
+        m_nodeIndexById.insert(m_nodes.at(n).id, n);
+    }
+    m_edgeIndexById.clear();
+    for (int e = 0; e < m_edges.size(); ++e) {
+        m_edgeIndexById.insert(m_edges.at(e).id, e);
+    }
+    m_adjacencyBuilt = false;
+    m_geometryBuilt = false;
+}
+
+LocalFrame LocalFrame::centeredOn(double lat, double lon) {
+    static constexpr double earthRadiusMeters = 6371000.0;
+    LocalFrame frame;
+    frame.originLat = lat;
+    frame.originLon = lon;
+    frame.metersPerDegreeLat = qDegreesToRadians(1.0) * earthRadiusMeters;
+    frame.metersPerDegreeLon = frame.metersPerDegreeLat * qCos(qDegreesToRadians(lat));
+    return frame;
+}
+
+void RoadGraph::buildGeometry() {
+    const int nodeCount = m_nodes.size();
+    const int edgeCount = m_edges.size();
+
+    // Origine au centre de l'emprise des nœuds
+    if (nodeCount > 0) {
+        double minLat = m_nodes.at(0).lat, maxLat = minLat;
+        double minLon = m_nodes.at(0).lon, maxLon = minLon;
+        for (const RoadNode& node : std::as_const(m_nodes)) {
+            minLat = std::min(minLat, node.lat);
+            maxLat = std::max(maxLat, node.lat);
+            minLon = std::min(minLon, node.lon);
+            maxLon = std::max(maxLon, node.lon);
+        }
+        m_localFrame = LocalFrame::centeredOn((minLat + maxLat) / 2.0, (minLon + maxLon) / 2.0);
+    } else {
+        m_localFrame = LocalFrame::centeredOn(0.0, 0.0);
+    }
+
+    m_nodeX.resize(nodeCount);
+    m_nodeY.resize(nodeCount);
+    for (int n = 0; n < nodeCount; ++n) {
+        const RoadNode& node = m_nodes.at(n);
+        m_localFrame.toLocal(node.lat, node.lon, m_nodeX[n], m_nodeY[n]);
+    }
+
+    m_edgeGeometry.fromX.fill(0.0, edgeCount);
+    m_edgeGeometry.fromY.fill(0.0, edgeCount);
+    m_edgeGeometry.deltaX.fill(0.0, edgeCount);
+    m_edgeGeometry.deltaY.fill(0.0, edgeCount);
+    m_edgeGeometry.inverseLength.fill(0.0, edgeCount);
+    for (int i = 0; i < edgeCount; ++i) {
+        const RoadEdge& edge = m_edges.at(i);
+        if (edge.fromNode < 0 || edge.toNode < 0 ||
+            edge.fromNode >= nodeCount || edge.toNode >= nodeCount) {
+            continue;
+        }
+        m_edgeGeometry.fromX[i] = m_nodeX.at(edge.fromNode);
+        m_edgeGeometry.fromY[i] = m_nodeY.at(edge.fromNode);
+        m_edgeGeometry.deltaX[i] = m_nodeX.at(edge.toNode) - m_nodeX.at(edge.fromNode);
+        m_edgeGeometry.deltaY[i] = m_nodeY.at(edge.toNode) - m_nodeY.at(edge.fromNode);
+        m_edgeGeometry.inverseLength[i] = edge.lengthMeters > 0.0 ? 1.0 / edge.lengthMeters : 0.0;
+    }
+
+    // Sommets des polylignes (extrémités comprises) et abscisses cumulées
+    EdgeGeometry& geometry = m_edgeGeometry;
+    geometry.shapeOffset.fill(0, edgeCount + 1);
+    geometry.shapeX.clear();
+    geometry.shapeY.clear();
+    geometry.shapeDistance.clear();
+    for (int i = 0; i < edgeCount; ++i) {
+        const RoadEdge& edge = m_edges.at(i);
+        const bool hasShape = edge.shapeBegin < edge.shapeEnd && geometry.inverseLength.at(i) > 0.0;
+        if (hasShape) {
+            double previousX = geometry.fromX.at(i);
+            double previousY = geometry.fromY.at(i);
+            double distance = 0.0;
+            auto appendVertex = [&](double x, double y) {
+                distance += std::hypot(x - previousX, y - previousY);
+                geometry.shapeX.append(x);
+                geometry.shapeY.append(y);
+                geometry.shapeDistance.append(distance);
+                previousX = x;
+                previousY = y;
+            };
+            appendVertex(previousX, previousY);
+            for (int k = edge.shapeBegin; k < edge.shapeEnd; ++k) {
+                double x = 0.0;
+                double y = 0.0;
+                m_localFrame.toLocal(m_shapePoints.at(k).lat, m_shapePoints.at(k).lon, x, y);
+                appendVertex(x, y);
+            }
+            appendVertex(m_nodeX.at(edge.toNode), m_nodeY.at(edge.toNode));
+        }
+        geometry.shapeOffset[i + 1] = geometry.shapeX.size();
+    }
+
+    m_geometryBuilt = true;
 }
 
 void RoadGraph::clear() {
     m_nodes.clear();
     m_edges.clear();
+    m_wayAttributes.clear();
+    m_shapePoints.clear();
     m_nodeIndexById.clear();
     m_edgeIndexById.clear();
+    m_wayAttributeIndexById.clear();
+    m_idIndexSorted = false;
+    m_sortedNodeIds.clear();
+    m_sortedEdgeIds.clear();
+    m_sortedWayAttributeIds.clear();
+    m_adjacencyBuilt = false;
+    m_outgoingOffsets.clear();
+    m_outgoingEdges.clear();
+    m_incomingOffsets.clear();
+    m_incomingEdges.clear();
+    m_geometryBuilt = false;
+    m_nodeX.clear();
+    m_nodeY.clear();
+    m_edgeGeometry = EdgeGeometry();
 }
 
@@ -1,16 +1,50 @@
 #pragma once
 
+#include <QAnyStringView>
 #include <QHash>
 #include <QVector>
 #include <QString>
 
+#include <algorithm>
+
 struct RoadEdge;
 
 struct RoadNode {
     qint64 id = 0;
     double lat = 0.0;
     double lon = 0.0;
-    QVector<int> outgoingEdges;
+};
+
+// Classe de route OSM (valeur de la clé highway) retenue par le chargeur
+enum class HighwayClass : quint8 {
+    Unsupported = 0,
+    Motorway,
+    MotorwayLink,
+    Trunk,
+    TrunkLink,
+    Primary,
+    PrimaryLink,
+    Secondary,
+    SecondaryLink,
+    Tertiary,
+    TertiaryLink,
+    Residential,
+    Unclassified,
+    LivingStreet,
+    Service
+};
+
+HighwayClass highwayClassFromName(QAnyStringView name);
+QString highwayClassName(HighwayClass highwayClass);
+
+// Attributs d'une voie OSM, partagés par toutes ses arêtes : stockés une seule
+// fois dans le graphe et référencés par indice depuis chaque arête
+struct WayAttributes {
+    qint64 wayId = 0;
+    double maxSpeedKmh = 50.0;
+    HighwayClass highwayClass = HighwayClass::Unsupported;
+    bool oneway = false;
+    quint8 reserved[6] = {}; // Bourrage explicite : la table est copiée telle quelle dans le cache
 };
 
 struct RoadEdge {
@@ -18,9 +52,85 @@ struct RoadEdge {
     int fromNode = -1;
     int toNode = -1;
     double lengthMeters = 0.0;
-    bool oneway = false;
-    double maxSpeedKmh = 50.0;
-    QString highwayType;
+    int attributeIndex = -1; // Indice dans RoadGraph::wayAttributes()
+    // Points intermédiaires (arête en polyligne) : RoadGraph::shapePoints()[shapeBegin, shapeEnd)
+    int shapeBegin = 0;
+    int shapeEnd = 0;
+    quint32 reserved = 0; // Bourrage explicite : les arêtes sont copiées telles quelles dans le cache
+};
+
+// Entrée d'une table identifiant OSM -> indice, triée par identifiant
+struct IdIndexEntry {
+    qint64 id = 0;
+    int index = -1;
+    quint32 reserved = 0; // Bourrage explicite : la table est copiée telle quelle dans le cache
+};
+
+// Vue sur une plage contiguë d'indices d'arêtes (adjacence CSR)
+struct EdgeIndexRange {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+    bool isEmpty() const { return first == last; }
+};
+
+// Repère métrique local (ENU : x vers l'est, y vers le nord, en mètres),
+// plan tangent centré sur l'emprise du graphe. À l'échelle d'une ville,
+// l'erreur de cette projection reste inférieure au mètre.
+struct LocalFrame {
+    double originLat = 0.0;
+    double originLon = 0.0;
+    double metersPerDegreeLat = 0.0;
+    double metersPerDegreeLon = 0.0;
+
+    static LocalFrame centeredOn(double lat, double lon);
+
+    void toLocal(double lat, double lon, double& x, double& y) const {
+        x = (lon - originLon) * metersPerDegreeLon;
+        y = (lat - originLat) * metersPerDegreeLat;
+    }
+    void toLatLon(double x, double y, double& lat, double& lon) const {
+        lat = originLat + y / metersPerDegreeLat;
+        lon = originLon + x / metersPerDegreeLon;
+    }
+};
+
+// Géométrie des arêtes dans le repère local, en tableaux parallèles indexés
+// par l'indice d'arête : un point d'une arête droite vaut from + delta * t, t dans [0, 1].
+// Une arête en polyligne a en plus ses sommets (extrémités comprises) et leurs
+// abscisses cumulées dans les tableaux shape*, sur la plage [shapeOffset[e], shapeOffset[e + 1]).
+struct EdgeGeometry {
+    QVector<double> fromX;
+    QVector<double> fromY;
+    QVector<double> deltaX;         // toX - fromX (m)
+    QVector<double> deltaY;         // toY - fromY (m)
+    QVector<double> inverseLength;  // 1 / lengthMeters, 0 pour une arête dégénérée ou invalide
+
+    QVector<int> shapeOffset;       // Plage vide pour une arête droite
+    QVector<double> shapeX;
+    QVector<double> shapeY;
+    QVector<double> shapeDistance;  // Distance (m) depuis le début de l'arête
+
+    bool isPolyline(int edgeIndex) const {
+        return shapeOffset.at(edgeIndex) != shapeOffset.at(edgeIndex + 1);
+    }
+    // Point à la fraction t d'une arête en polyligne : recherche dichotomique du
+    // segment dans les abscisses cumulées
+    void pointOnShape(int edgeIndex, double t, double& x, double& y) const {
+        const int first = shapeOffset.at(edgeIndex);
+        const int last = shapeOffset.at(edgeIndex + 1) - 1;
+        const double* distance = shapeDistance.constData();
+        const double target = t * distance[last];
+        const int end = static_cast<int>(std::upper_bound(distance + first + 1, distance + last, target) - distance);
+        const int begin = end - 1;
+        const double segment = distance[end] - distance[begin];
+        const double u = segment > 0.0 ? (target - distance[begin]) / segment : 0.0;
+        x = shapeX.at(begin) + (shapeX.at(end) - shapeX.at(begin)) * u;
+        y = shapeY.at(begin) + (shapeY.at(end) - shapeY.at(begin)) * u;
+    }
 };
 
 class RoadGraph {
@@ -35,12 +145,79 @@ public:
     const QVector<RoadNode>& nodes() const { return m_nodes; }
     const QVector<RoadEdge>& edges() const { return m_edges; }
 
+    // Points intermédiaires des arêtes en polyligne (géométrie d'origine des chaînes fusionnées)
+    const QVector<RoadNode>& shapePoints() const { return m_shapePoints; }
+
+    // Fusionne les chaînes de nœuds de degré 2 (deux voisins, attributs de voie
+    // identiques, sens de circulation cohérent) en arêtes uniques en polyligne ;
+    // les nœuds intérieurs deviennent des points de forme. Invalide l'adjacence
+    // et la géométrie. Retourne le nombre d'arêtes supprimées.
+    int contractDegreeTwoChains();
+
+    // Renumérote nœuds et arêtes pour la localité mémoire : nœuds dans l'ordre
+    // d'une courbe de Hilbert sur leurs coordonnées, arêtes triées par nœud
+    // d'origine. Des éléments proches sur la carte deviennent proches en mémoire.
+    // Invalide l'adjacence et la géométrie.
+    void reorderForLocality();
+
+    // Table des attributs de voie : ajouter deux fois la même voie retourne le même indice
+    int addWayAttributes(const WayAttributes& attributes);
+    const QVector<WayAttributes>& wayAttributes() const { return m_wayAttributes; }
+    // Attributs de l'arête (valeurs par défaut si l'arête n'en référence aucun)
+    const WayAttributes& edgeAttributes(int edgeIndex) const;
+
+    // Adjacence compressée (CSR) : à construire une fois le chargement terminé.
+    // Toute modification ultérieure du graphe l'invalide. Les recherches par
+    // identifiant passent alors des tables de hachage de construction à des
+    // tables triées (recherche dichotomique), stockées telles quelles dans le cache.
+    void buildAdjacency();
+    bool hasAdjacency() const { return m_adjacencyBuilt; }
+    EdgeIndexRange outgoingEdges(int nodeIndex) const;
+    EdgeIndexRange incomingEdges(int nodeIndex) const;
+
+    // Positions métriques des nœuds et géométrie des arêtes : à construire une
+    // fois le chargement terminé. Toute modification ultérieure du graphe l'invalide.
+    void buildGeometry();
+    bool hasGeometry() const { return m_geometryBuilt; }
+    const LocalFrame& localFrame() const { return m_localFrame; }
+    const QVector<double>& nodeX() const { return m_nodeX; }
+    const QVector<double>& nodeY() const { return m_nodeY; }
+    const EdgeGeometry& edgeGeometry() const { return m_edgeGeometry; }
+
     void clear();
 
 private:
+    friend class RoadGraphCache;
+
     QVector<RoadNode> m_nodes;
     QVector<RoadEdge> m_edges;
+    QVector<WayAttributes> m_wayAttributes;
+    QVector<RoadNode> m_shapePoints;
+
+    // CSR : les arêtes du nœud n sont edges[offsets[n] .. offsets[n + 1]]
+    bool m_adjacencyBuilt = false;
+    QVector<int> m_outgoingOffsets;
+    QVector<int> m_outgoingEdges;
+    QVector<int> m_incomingOffsets;
+    QVector<int> m_incomingEdges;
+
+    bool m_geometryBuilt = false;
+    LocalFrame m_localFrame;
+    QVector<double> m_nodeX;
+    QVector<double> m_nodeY;
+    EdgeGeometry m_edgeGeometry;
+
+    // Identifiant -> indice : tables de hachage pendant la construction (dédoublonnage),
+    // remplacées par des tables triées une fois l'adjacence construite
     QHash<qint64, int> m_nodeIndexById;
     QHash<qint64, int> m_edgeIndexById;
+    QHash<qint64, int> m_wayAttributeIndexById;
+    bool m_idIndexSorted = false;
+    QVector<IdIndexEntry> m_sortedNodeIds;
+    QVector<IdIndexEntry> m_sortedEdgeIds;
+    QVector<IdIndexEntry> m_sortedWayAttributeIds;
+
+    void sortIdIndex();
+    void unsortIdIndex();
 };
 
@@ -0,0 +1,354 @@
+#include "RoadGraphCache.h"
+
+#include "RoadGraph.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<RoadNode>, "RoadNode est copié tel quel dans le cache");
+static_assert(std::is_trivially_copyable_v<RoadEdge>, "RoadEdge est copié tel quel dans le cache");
+static_assert(std::is_trivially_copyable_v<WayAttributes>, "WayAttributes est copié tel quel dans le cache");
+static_assert(std::is_trivially_copyable_v<IdIndexEntry>, "IdIndexEntry est copié tel quel dans le cache");
+static_assert(std::is_trivially_copyable_v<LocalFrame>, "LocalFrame est copié tel quel dans le cache");
+// Aucun bourrage implicite (octets non initialisés) : deux graphes identiques
+// donnent des fichiers identiques octet pour octet
+static_assert(sizeof(RoadNode) == 24, "RoadNode : bourrage implicite");
+static_assert(sizeof(RoadEdge) == 40, "RoadEdge : bourrage implicite, compléter reserved");
+static_assert(sizeof(WayAttributes) == 24, "WayAttributes : bourrage implicite, compléter reserved");
+static_assert(sizeof(IdIndexEntry) == 16, "IdIndexEntry : bourrage implicite, compléter reserved");
+
+namespace {
+enum Section {
+    NodesSection = 0,
+    EdgesSection,
+    WayAttributesSection,
+    ShapePointsSection,
+    OutgoingOffsetsSection,
+    OutgoingEdgesSection,
+    IncomingOffsetsSection,
+    IncomingEdgesSection,
+    NodeIdsSection,
+    EdgeIdsSection,
+    WayAttributeIdsSection,
+    NodeXSection,
+    NodeYSection,
+    EdgeFromXSection,
+    EdgeFromYSection,
+    EdgeDeltaXSection,
+    EdgeDeltaYSection,
+    EdgeInverseLengthSection,
+    ShapeOffsetSection,
+    ShapeXSection,
+    ShapeYSection,
+    ShapeDistanceSection,
+    SectionCount
+};
+
+struct FileHeader {
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 sourceKey = 0;
+    // Tailles des éléments : un cache écrit par une autre compilation est rejeté
+    quint32 nodeSize = 0;
+    quint32 edgeSize = 0;
+    quint32 wayAttributesSize = 0;
+    quint32 idIndexEntrySize = 0;
+    LocalFrame localFrame;
+    qint64 counts[SectionCount] = {};
+};
+
+// Chaque section commence sur un multiple de 8 octets
+constexpr qint64 SECTION_ALIGNMENT = 8;
+
+qint64 paddedSize(qint64 bytes) {
+    return (bytes + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+template <typename T>
+bool writeSection(QSaveFile& file, const QVector<T>& values) {
+    const qint64 bytes = static_cast<qint64>(values.size()) * static_cast<qint64>(sizeof(T));
+    if (bytes > 0 && file.write(reinterpret_cast<const char*>(values.constData()), bytes) != bytes) {
+        return false;
+    }
+    static const char padding[SECTION_ALIGNMENT] = {};
+    const qint64 paddingBytes = paddedSize(bytes) - bytes;
+    return paddingBytes == 0 || file.write(padding, paddingBytes) == paddingBytes;
+}
+
+template <typename T>
+void readSection(const uchar* data, qint64& offset, qint64 count, QVector<T>& values) {
+    values.resize(static_cast<int>(count));
+    const qint64 bytes = count * static_cast<qint64>(sizeof(T));
+    if (bytes > 0) {
+        std::memcpy(values.data(), data + offset, static_cast<size_t>(bytes));
+    }
+    offset += paddedSize(bytes);
+}
+
+// Bornes CSR croissantes, de 0 à total
+bool isValidOffsets(const QVector<int>& offsets, int rangeCount, int total) {
+    if (offsets.size() != rangeCount + 1 || offsets.first() != 0 || offsets.last() != total) return false;
+    for (int i = 0; i < rangeCount; ++i) {
+        if (offsets.at(i) > offsets.at(i + 1)) return false;
+    }
+    return true;
+}
+
+// Table triée strictement par identifiant, chaque entrée désignant l'élément de cet identifiant
+template <typename T, typename IdOf>
+bool isValidIdTable(const QVector<IdIndexEntry>& table, const QVector<T>& elements, IdOf idOf) {
+    if (table.size() != elements.size()) return false;
+    for (int i = 0; i < table.size(); ++i) {
+        const IdIndexEntry& entry = table.at(i);
+        if (entry.index < 0 || entry.index >= elements.size() || idOf(elements.at(entry.index)) != entry.id) {
+            return false;
+        }
+        if (i > 0 && table.at(i - 1).id >= entry.id) return false;
+    }
+    return true;
+}
+} // namespace
+
+template <typename Graph, typename Visitor>
+void RoadGraphCache::forEachSection(Graph& graph, Visitor&& visit) {
+    visit(NodesSection, graph.m_nodes);
+    visit(EdgesSection, graph.m_edges);
+    visit(WayAttributesSection, graph.m_wayAttributes);
+    visit(ShapePointsSection, graph.m_shapePoints);
+    visit(OutgoingOffsetsSection, graph.m_outgoingOffsets);
+    visit(OutgoingEdgesSection, graph.m_outgoingEdges);
+    visit(IncomingOffsetsSection, graph.m_incomingOffsets);
+    visit(IncomingEdgesSection, graph.m_incomingEdges);
+    visit(NodeIdsSection, graph.m_sortedNodeIds);
+    visit(EdgeIdsSection, graph.m_sortedEdgeIds);
+    visit(WayAttributeIdsSection, graph.m_sortedWayAttributeIds);
+    visit(NodeXSection, graph.m_nodeX);
+    visit(NodeYSection, graph.m_nodeY);
+    visit(EdgeFromXSection, graph.m_edgeGeometry.fromX);
+    visit(EdgeFromYSection, graph.m_edgeGeometry.fromY);
+    visit(EdgeDeltaXSection, graph.m_edgeGeometry.deltaX);
+    visit(EdgeDeltaYSection, graph.m_edgeGeometry.deltaY);
+    visit(EdgeInverseLengthSection, graph.m_edgeGeometry.inverseLength);
+    visit(ShapeOffsetSection, graph.m_edgeGeometry.shapeOffset);
+    visit(ShapeXSection, graph.m_edgeGeometry.shapeX);
+    visit(ShapeYSection, graph.m_edgeGeometry.shapeY);
+    visit(ShapeDistanceSection, graph.m_edgeGeometry.shapeDistance);
+}
+
+bool RoadGraphCache::isConsistent(const RoadGraph& graph) {
+    const int nodeCount = graph.m_nodes.size();
+    const int edgeCount = graph.m_edges.size();
+    const int wayAttributeCount = graph.m_wayAttributes.size();
+    const int shapePointCount = graph.m_shapePoints.size();
+    const EdgeGeometry& geometry = graph.m_edgeGeometry;
+
+    if (graph.m_nodeX.size() != nodeCount || graph.m_nodeY.size() != nodeCount
+        || geometry.fromX.size() != edgeCount || geometry.fromY.size() != edgeCount
+        || geometry.deltaX.size() != edgeCount || geometry.deltaY.size() != edgeCount
+        || geometry.inverseLength.size() != edgeCount
+        || geometry.shapeY.size() != geometry.shapeX.size()
+        || geometry.shapeDistance.size() != geometry.shapeX.size()) {
+        return false;
+    }
+
+    for (const RoadEdge& edge : graph.m_edges) {
+        if (edge.fromNode < 0 || edge.fromNode >= nodeCount || edge.toNode < 0 || edge.toNode >= nodeCount
+            || edge.attributeIndex < -1 || edge.attributeIndex >= wayAttributeCount
+            || edge.shapeBegin < 0 || edge.shapeBegin > edge.shapeEnd || edge.shapeEnd > shapePointCount) {
+            return false;
+        }
+    }
+
+    // Adjacence : chaque arête une fois dans chaque sens de parcours, rangée sous son nœud
+    if (!isValidOffsets(graph.m_outgoingOffsets, nodeCount, edgeCount)
+        || !isValidOffsets(graph.m_incomingOffsets, nodeCount, edgeCount)
+        || graph.m_outgoingEdges.size() != edgeCount || graph.m_incomingEdges.size() != edgeCount) {
+        return false;
+    }
+    for (int n = 0; n < nodeCount; ++n) {
+        for (int k = graph.m_outgoingOffsets.at(n); k < graph.m_outgoingOffsets.at(n + 1); ++k) {
+            const int e = graph.m_outgoingEdges.at(k);
+            if (e < 0 || e >= edgeCount || graph.m_edges.at(e).fromNode != n) return false;
+        }
+        for (int k = graph.m_incomingOffsets.at(n); k < graph.m_incomingOffsets.at(n + 1); ++k) {
+            const int e = graph.m_incomingEdges.at(k);
+            if (e < 0 || e >= edgeCount || graph.m_edges.at(e).toNode != n) return false;
+        }
+    }
+
+    if (!isValidIdTable(graph.m_sortedNodeIds, graph.m_nodes, [](const RoadNode& node) { return node.id; })
+        || !isValidIdTable(graph.m_sortedEdgeIds, graph.m_edges, [](const RoadEdge& edge) { return edge.id; })
+        || !isValidIdTable(graph.m_sortedWayAttributeIds, graph.m_wayAttributes,
+                           [](const WayAttributes& way) { return way.wayId; })) {
+        return false;
+    }
+
+    // Polylignes : au moins deux sommets (extrémités) par plage non vide
+    if (!isValidOffsets(geometry.shapeOffset, edgeCount, geometry.shapeX.size())) return false;
+    for (int e = 0; e < edgeCount; ++e) {
+        const int vertexCount = geometry.shapeOffset.at(e + 1) - geometry.shapeOffset.at(e);
+        if (vertexCount == 1) return false;
+    }
+    return true;
+}
+
+QString RoadGraphCache::cachePathFor(const QString& sourcePath, bool contractedChains) {
+    return sourcePath + (contractedChains ? QStringLiteral(".graphcache") : QStringLiteral(".raw.graphcache"));
+}
+
+QString RoadGraphCache::hierarchyPathFor(const QString& sourcePath, bool contractedChains) {
+    return sourcePath + (contractedChains ? QStringLiteral(".chcache") : QStringLiteral(".raw.chcache"));
+}
+
+quint64 RoadGraphCache::sourceKey(const QString& sourcePath) {
+    QFile file(sourcePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QFileInfo info(file);
+
+    // FNV-1a sur la taille, la date de modification et quelques blocs répartis
+    // dans le fichier : lire tout un extrait régional coûterait autant que l'analyser
+    quint64 hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](const char* bytes, qint64 size) {
+        for (qint64 i = 0; i < size; ++i) {
+            hash ^= static_cast<uchar>(bytes[i]);
+            hash *= 0x100000001b3ULL;
+        }
+    };
+    const qint64 size = file.size();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    mix(reinterpret_cast<const char*>(&size), sizeof(size));
+    mix(reinterpret_cast<const char*>(&modified), sizeof(modified));
+
+    QByteArray block;
+    for (int i = 0; i < SAMPLE_COUNT; ++i) {
+        const qint64 position = size > SAMPLE_BYTES ? (size - SAMPLE_BYTES) * i / (SAMPLE_COUNT - 1) : 0;
+        if (!file.seek(position)) {
+            return 0;
+        }
+        block = file.read(SAMPLE_BYTES);
+        mix(block.constData(), block.size());
+        if (size <= SAMPLE_BYTES) break;
+    }
+    // 0 est réservé au fichier illisible
+    return hash != 0 ? hash : 1;
+}
+
+bool RoadGraphCache::save(const QString& cachePath, const RoadGraph& graph, quint64 sourceKey,
+                          QString* errorMessage) {
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+    if (!graph.m_adjacencyBuilt || !graph.m_idIndexSorted || !graph.m_geometryBuilt) {
+        return fail(QStringLiteral("Adjacence ou géométrie du graphe non construite"));
+    }
+
+    FileHeader header;
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.sourceKey = sourceKey;
+    header.nodeSize = sizeof(RoadNode);
+    header.edgeSize = sizeof(RoadEdge);
+    header.wayAttributesSize = sizeof(WayAttributes);
+    header.idIndexEntrySize = sizeof(IdIndexEntry);
+    header.localFrame = graph.m_localFrame;
+    forEachSection(graph, [&header](Section section, const auto& values) {
+        header.counts[section] = values.size();
+    });
+
+    // Écriture dans un fichier temporaire renommé à la fin : un cache interrompu
+    // n'est jamais relu
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(QStringLiteral("Impossible d'écrire le cache du graphe: %1").arg(file.errorString()));
+    }
+    bool written = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+    forEachSection(graph, [&file, &written](Section, const auto& values) {
+        written = written && writeSection(file, values);
+    });
+    if (!written || !file.commit()) {
+        return fail(QStringLiteral("Erreur d'écriture du cache du graphe: %1").arg(file.errorString()));
+    }
+    return true;
+}
+
+bool RoadGraphCache::load(const QString& cachePath, quint64 sourceKey, RoadGraph& graph,
+                          QString* errorMessage) {
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("Impossible d'ouvrir le cache du graphe: %1").arg(file.errorString()));
+    }
+    const qint64 fileSize = file.size();
+    if (fileSize < static_cast<qint64>(sizeof(FileHeader))) {
+        return fail(QStringLiteral("Cache du graphe tronqué"));
+    }
+    const uchar* data = file.map(0, fileSize);
+    if (!data) {
+        return fail(QStringLiteral("Impossible de projeter le cache du graphe: %1").arg(file.errorString()));
+    }
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION
+        || header.nodeSize != sizeof(RoadNode) || header.edgeSize != sizeof(RoadEdge)
+        || header.wayAttributesSize != sizeof(WayAttributes) || header.idIndexEntrySize != sizeof(IdIndexEntry)) {
+        return fail(QStringLiteral("Format de cache du graphe non reconnu"));
+    }
+    if (header.sourceKey != sourceKey) {
+        return fail(QStringLiteral("Le cache du graphe ne correspond pas au fichier source"));
+    }
+
+    // Les tailles annoncées doivent couvrir exactement le fichier : aucune
+    // section ne peut déborder de la projection
+    RoadGraph loaded;
+    qint64 expectedSize = sizeof(FileHeader);
+    bool validCounts = true;
+    forEachSection(loaded, [&](Section section, const auto& values) {
+        using Element = typename std::decay_t<decltype(values)>::value_type;
+        const qint64 count = header.counts[section];
+        if (count < 0 || count > std::numeric_limits<int>::max()) {
+            validCounts = false;
+            return;
+        }
+        expectedSize += paddedSize(count * static_cast<qint64>(sizeof(Element)));
+    });
+    if (!validCounts || expectedSize != fileSize) {
+        return fail(QStringLiteral("Cache du graphe tronqué ou corrompu"));
+    }
+
+    // Copie d'un bloc par section, sans reconstruction élément par élément
+    qint64 offset = sizeof(FileHeader);
+    forEachSection(loaded, [&](Section section, auto& values) {
+        readSection(data, offset, header.counts[section], values);
+    });
+    file.unmap(const_cast<uchar*>(data));
+
+    // Indices relus sur disque : vérifiés avant toute utilisation
+    if (!isConsistent(loaded)) {
+        return fail(QStringLiteral("Cache du graphe corrompu"));
+    }
+    loaded.m_adjacencyBuilt = true;
+    loaded.m_idIndexSorted = true;
+    loaded.m_localFrame = header.localFrame;
+    loaded.m_geometryBuilt = true;
+
+    graph = std::move(loaded);
+    return true;
+}
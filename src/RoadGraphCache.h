@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+class RoadGraph;
+
+// Cache binaire d'un graphe routier entièrement construit (nœuds, arêtes, table
+// des attributs de voie, points de forme, adjacence CSR, tables d'identifiants
+// triées, géométrie locale), écrit après le premier chargement d'un fichier OSM.
+// Les tableaux y sont stockés tels qu'en mémoire : la relecture projette le
+// fichier (QFile::map) et copie chaque section d'un bloc, sans rien reconstruire.
+// Les indices relus (extrémités, attributs, plages CSR et de forme, tables
+// d'identifiants) sont vérifiés : un cache tronqué ou corrompu est rejeté.
+// Le format dépend de la plateforme (boutisme, taille des structures) : un cache
+// incompatible est simplement rejeté et le fichier source rechargé.
+class RoadGraphCache {
+public:
+    // Emplacement du cache associé à un fichier source ; un graphe construit sans
+    // fusion des chaînes de degré 2 a son propre cache
+    static QString cachePathFor(const QString& sourcePath, bool contractedChains = true);
+    // Emplacement de la hiérarchie de routage du même graphe (ContractionHierarchy::save/load)
+    static QString hierarchyPathFor(const QString& sourcePath, bool contractedChains = true);
+
+    // Clé du fichier source : empreinte FNV-1a de sa taille, de sa date de
+    // modification et de SAMPLE_COUNT blocs de SAMPLE_BYTES répartis dans le
+    // fichier. Ce n'est pas une empreinte du contenu complet : une modification
+    // entre deux blocs échantillonnés, sans changement de taille ni de date,
+    // n'est pas détectée. Retourne 0 si le fichier est illisible.
+    static quint64 sourceKey(const QString& sourcePath);
+
+    // L'adjacence et la géométrie du graphe doivent être construites
+    static bool save(const QString& cachePath, const RoadGraph& graph, quint64 sourceKey,
+                     QString* errorMessage = nullptr);
+    // Échoue si le cache est absent, d'une autre version ou construit pour une autre clé
+    static bool load(const QString& cachePath, quint64 sourceKey, RoadGraph& graph,
+                     QString* errorMessage = nullptr);
+
+private:
+    static constexpr quint32 FILE_MAGIC = 0x56324752; // "V2GR"
+    // À incrémenter à chaque changement du format ou de la construction du graphe
+    // (chargeur, nœuds retenus, fusion des chaînes, renumérotation)
+    static constexpr quint32 FILE_VERSION = 6;
+    static constexpr int SAMPLE_COUNT = 16;          // Blocs lus pour la clé du fichier source
+    static constexpr qint64 SAMPLE_BYTES = 4096;
+
+    // Sections du fichier dans l'ordre d'écriture : visit(section, tableau)
+    template <typename Graph, typename Visitor>
+    static void forEachSection(Graph& graph, Visitor&& visit);
+    static bool isConsistent(const RoadGraph& graph);
+};
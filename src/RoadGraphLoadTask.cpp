@@ -0,0 +1,88 @@
+#include "RoadGraphLoadTask.h"
+
+#include "RoadGraphCache.h"
+#include "RoadGraphLoader.h"
+
+#include <QDebug>
+#include <QThread>
+
+RoadGraphLoadTask::RoadGraphLoadTask(const QString& filePath, QObject* parent)
+    : QObject(parent), m_filePath(filePath) {}
+
+RoadGraphLoadTask::~RoadGraphLoadTask() {
+    if (m_thread) {
+        cancel();
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+QString RoadGraphLoadTask::hierarchyCachePath() const {
+    return RoadGraphCache::hierarchyPathFor(m_filePath, m_contractDegreeTwoChains);
+}
+
+void RoadGraphLoadTask::start() {
+    if (m_thread) return;
+    m_running = true;
+    m_thread = QThread::create([this]() { run(); });
+    connect(m_thread, &QThread::finished, this, &RoadGraphLoadTask::onThreadFinished);
+    m_thread->start();
+}
+
+void RoadGraphLoadTask::cancel() {
+    m_cancelRequested.store(true);
+}
+
+RoadGraph RoadGraphLoadTask::takeGraph() {
+    RoadGraph graph = std::move(m_graph);
+    m_graph = RoadGraph();
+    return graph;
+}
+
+void RoadGraphLoadTask::onThreadFinished() {
+    m_running = false;
+    if (!m_success && m_cancelRequested.load()) {
+        m_errorMessage = QStringLiteral("Chargement annulé");
+    }
+    emit finished(m_success, m_errorMessage);
+}
+
+void RoadGraphLoadTask::run() {
+    RoadGraph graph;
+    QString error;
+
+    // Graphe déjà construit pour ce fichier : relecture directe du cache binaire
+    const QString cachePath = RoadGraphCache::cachePathFor(m_filePath, m_contractDegreeTwoChains);
+    const quint64 sourceKey = RoadGraphCache::sourceKey(m_filePath);
+    if (sourceKey != 0 && RoadGraphCache::load(cachePath, sourceKey, graph, &error)) {
+        qInfo() << "Graphe routier chargé depuis le cache:" << cachePath;
+    } else {
+        // Signaux de progression limités aux changements visibles
+        int lastStep = -1;
+        RoadGraphLoader::Options options;
+        options.cancelRequested = &m_cancelRequested;
+        // Les rues découpées à chaque nœud OSM deviennent des arêtes en polyligne :
+        // moins de transitions d'arête pendant la simulation, même tracé à l'écran
+        options.contractDegreeTwoChains = m_contractDegreeTwoChains;
+        options.progress = [this, &lastStep](const RoadGraphLoader::LoadProgress& progress) {
+            const int step = progress.totalBytes > 0
+                                 ? static_cast<int>(progress.processedBytes * PROGRESS_STEPS / progress.totalBytes)
+                                 : 0;
+            if (step == lastStep) return;
+            lastStep = step;
+            emit progressChanged(progress.processedBytes, progress.totalBytes, progress.wayCount);
+        };
+        if (!RoadGraphLoader::loadFromOsmFile(m_filePath, graph, options, &error)) {
+            m_errorMessage = error;
+            return;
+        }
+        if (m_cancelRequested.load()) return;
+        if (sourceKey != 0 && !RoadGraphCache::save(cachePath, graph, sourceKey, &error)) {
+            qWarning() << "Cache du graphe routier non écrit:" << error;
+        }
+    }
+
+    if (m_cancelRequested.load()) return;
+    m_graph = std::move(graph);
+    m_success = true;
+}
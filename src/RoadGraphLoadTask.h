@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+#include "RoadGraph.h"
+
+class QThread;
+
+// Chargement d'un graphe routier sur un thread dédié : relecture du cache
+// binaire ou analyse du fichier OSM, fusion des chaînes de degré 2 (optionnelle,
+// activée par défaut), adjacence et géométrie, puis écriture du cache. Le graphe terminé est récupéré d'un
+// bloc par takeGraph() ; l'interface reste réactive pendant tout le chargement.
+// Les signaux sont reçus dans le thread de l'objet.
+class RoadGraphLoadTask : public QObject {
+    Q_OBJECT
+public:
+    explicit RoadGraphLoadTask(const QString& filePath, QObject* parent = nullptr);
+    // Annule un chargement en cours et attend la fin du thread
+    ~RoadGraphLoadTask() override;
+
+    const QString& filePath() const { return m_filePath; }
+
+    // Fusion des chaînes de degré 2 en arêtes en polyligne (vrai par défaut), à
+    // régler avant start(). Les graphes fusionnés ou non ont des caches distincts.
+    void setContractDegreeTwoChains(bool enabled) { m_contractDegreeTwoChains = enabled; }
+    bool contractDegreeTwoChains() const { return m_contractDegreeTwoChains; }
+    // Emplacement de la hiérarchie de routage associée au graphe chargé
+    QString hierarchyCachePath() const;
+
+    void start();
+    // Demande l'arrêt de la lecture ; finished(false, ...) suit
+    void cancel();
+    bool isCancelRequested() const { return m_cancelRequested.load(); }
+    // Vrai entre start() et l'émission de finished()
+    bool isRunning() const { return m_running; }
+
+    // Graphe chargé, à récupérer une fois finished(true, ...) émis
+    RoadGraph takeGraph();
+
+signals:
+    void progressChanged(qint64 processedBytes, qint64 totalBytes, qint64 wayCount);
+    void finished(bool success, const QString& errorMessage);
+
+private slots:
+    void onThreadFinished();
+
+private:
+    static constexpr int PROGRESS_STEPS = 1000; // Granularité des signaux de progression
+
+    void run(); // Thread de chargement
+
+    QString m_filePath;
+    bool m_contractDegreeTwoChains = true;
+    QThread* m_thread = nullptr;
+    bool m_running = false;
+    std::atomic<bool> m_cancelRequested{false};
+
+    // Écrits par le thread de chargement, lus après sa fin
+    RoadGraph m_graph;
+    bool m_success = false;
+    QString m_errorMessage;
+};
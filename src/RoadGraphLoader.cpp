@@ -1,13 +1,18 @@
 #include "RoadGraphLoader.h"
 
 #include "RoadGraph.h"
+#include "Proximity.h"
 
+#include "ThreadPool.h"
+
+#include <QDebug>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QTemporaryFile>
 #include <QXmlStreamReader>
 #include <QtMath>
-#include <QSet>
-#include <QRegularExpression>
+#include <algorithm>
 #include <exception>
 #include <cstddef>
 
@@ -16,325 +21,627 @@
 #include <osmium/visitor.hpp>
 #include <osmium/handler/node_locations.hpp>
 #include <osmium/index/map/sparse_mem_array.hpp>
+#include <osmium/index/map/dense_file_array.hpp>
+#include <osmium/thread/pool.hpp>
+#include <vector>
 #endif
 
 namespace {
-double haversine(double lat1, double lon1, double lat2, double lon2) {
-    static constexpr double earthRadiusMeters = 6371000.0;
-    double lat1Rad = qDegreesToRadians(lat1);
-    double lon1Rad = qDegreesToRadians(lon1);
-    double lat2Rad = qDegreesToRadians(lat2);
-    double lon2Rad = qDegreesToRadians(lon2);
-    double dlat = lat2Rad - lat1Rad;
-    double dlon = lon2Rad - lon1Rad;
-    double a = qSin(dlat / 2) * qSin(dlat / 2) +
-               qCos(lat1Rad) * qCos(lat2Rad) * qSin(dlon / 2) * qSin(dlon / 2);
-    double c = 2 * qAtan2(qSqrt(a), qSqrt(1 - a));
-    return earthRadiusMeters * c;
-}
+// Les valeurs de tags sont lues sur des vues (QStringView pour le XML,
+// QLatin1StringView pour le PBF) sans copie : les fonctions ci-dessous sont
+// génériques sur le type de vue.
+
+constexpr double DEFAULT_MAX_SPEED_KMH = 50.0;
+constexpr double KMH_PER_MPH = 1.60934;
+constexpr double KMH_PER_KNOT = 1.852;
+
+// Limitations implicites "<pays>:<zone>" dont la valeur diffère de la valeur générique de la zone
+struct ImplicitMaxSpeed {
+    const char* value;
+    double kmh;
+};
 
-bool isHighwayTypeSupported(const QString& value) {
-    static const QSet<QString> supportedTypes = {
-        "motorway", "motorway_link", "trunk", "trunk_link",
-        "primary", "primary_link", "secondary", "secondary_link",
-        "tertiary", "tertiary_link", "residential", "unclassified",
-        "living_street", "service"
-    };
-    return supportedTypes.contains(value);
-}
+const ImplicitMaxSpeed COUNTRY_MAX_SPEEDS[] = {
+    {"FR:rural", 80.0},
+    {"DE:rural", 100.0},
+    {"AT:rural", 100.0},
+    {"CH:rural", 80.0},
+    {"BE-VLG:rural", 70.0},
+    {"NL:rural", 80.0},
+    {"DE:living_street", 7.0},
+    {"CH:motorway", 120.0},
+    {"GB:nsl_single", 96.56},
+    {"GB:nsl_dual", 112.65},
+    {"GB:motorway", 112.65},
+};
 
-bool isOnewayValueTrue(const QString& value) {
-    static const QSet<QString> trueVals = {"yes", "true", "1"};
-    static const QSet<QString> falseVals = {"no", "false", "0"};
-    if (trueVals.contains(value)) return true;
-    if (falseVals.contains(value)) return false;
-    if (value == "-1") return true; // backwards but handle later
-    return false;
-}
+// Valeurs génériques par zone, quel que soit le pays
+const ImplicitMaxSpeed ZONE_MAX_SPEEDS[] = {
+    {"urban", 50.0},
+    {"rural", 90.0},
+    {"trunk", 110.0},
+    {"motorway", 130.0},
+    {"living_street", 20.0},
+    {"bicycle_road", 30.0},
+    {"walk", 6.0},
+};
 
-#ifdef HAVE_LIBOSMIUM
-class RoadGraphBuilderHandler : public osmium::handler::Handler {
-public:
-    explicit RoadGraphBuilderHandler(RoadGraph& graph) : m_graph(graph) {}
+enum class OnewayDirection : quint8 {
+    Unspecified, // Tag absent
+    No,
+    Forward,
+    Reverse      // oneway=-1 : circulation dans le sens inverse des nœuds
+};
 
-    void way(const osmium::Way& way) {
-        const char* highway = way.tags()["highway"];
-        if (!highway) return;
-        QString highwayType = QString::fromUtf8(highway);
-        if (!isHighwayTypeSupported(highwayType)) return;
+template <typename View>
+bool isAsciiDigit(View view, qsizetype i) {
+    const char16_t c = view.at(i).unicode();
+    return c >= u'0' && c <= u'9';
+}
 
-        QString onewayTag;
-        if (way.tags().has_key("oneway")) {
-            onewayTag = QString::fromUtf8(way.tags()["oneway"]);
+// Nombre décimal en tête de value (chiffres, partie décimale facultative) ;
+// position retournée dans end, -1 si value ne commence pas par un chiffre
+template <typename View>
+double parseLeadingNumber(View value, qsizetype& end) {
+    qsizetype i = 0;
+    double number = 0.0;
+    if (value.isEmpty() || !isAsciiDigit(value, 0)) {
+        end = -1;
+        return 0.0;
+    }
+    for (; i < value.size() && isAsciiDigit(value, i); ++i) {
+        number = number * 10.0 + (value.at(i).unicode() - u'0');
+    }
+    if (i + 1 < value.size() && value.at(i).unicode() == u'.' && isAsciiDigit(value, i + 1)) {
+        double scale = 0.1;
+        for (++i; i < value.size() && isAsciiDigit(value, i); ++i) {
+            number += (value.at(i).unicode() - u'0') * scale;
+            scale *= 0.1;
         }
-        bool oneway = isOnewayValueTrue(onewayTag) || onewayTag == QLatin1String("-1");
-        bool reverseOneway = onewayTag == QLatin1String("-1");
+    }
+    end = i;
+    return number;
+}
 
-        QString maxSpeedTag;
-        if (way.tags().has_key("maxspeed")) {
-            maxSpeedTag = QString::fromUtf8(way.tags()["maxspeed"]);
+// Valeur du tag maxspeed en km/h : nombre suivi d'une unité facultative
+// ("50", "50 km/h", "30 mph", "10 knots"), limitation implicite ("FR:urban",
+// "DE:zone30") ou "none". Valeur par défaut si le tag est absent ou illisible.
+template <typename View>
+double parseMaxSpeedKmh(View value) {
+    value = value.trimmed();
+    if (value.isEmpty()) return DEFAULT_MAX_SPEED_KMH;
+
+    qsizetype numberEnd = -1;
+    const double number = parseLeadingNumber(value, numberEnd);
+    if (numberEnd >= 0) {
+        const View unit = value.mid(numberEnd).trimmed();
+        if (unit.isEmpty() || unit.compare(QLatin1String("km/h"), Qt::CaseInsensitive) == 0
+            || unit.compare(QLatin1String("kmh"), Qt::CaseInsensitive) == 0
+            || unit.compare(QLatin1String("kph"), Qt::CaseInsensitive) == 0) {
+            return number;
         }
-        double maxSpeed = parseMaxSpeedKmh(maxSpeedTag);
-
-        const auto& nodes = way.nodes();
-        for (std::size_t i = 0; i + 1 < nodes.size(); ++i) {
-            const auto& fromRef = nodes[i];
-            const auto& toRef = nodes[i + 1];
-            if (!fromRef.location().valid() || !toRef.location().valid()) {
-                continue;
-            }
-
-            int fromIndex = ensureNode(fromRef);
-            int toIndex = ensureNode(toRef);
-            if (fromIndex < 0 || toIndex < 0) continue;
-
-            double length = haversine(fromRef.location().lat(), fromRef.location().lon(),
-                                      toRef.location().lat(), toRef.location().lon());
+        if (unit.compare(QLatin1String("mph"), Qt::CaseInsensitive) == 0) return number * KMH_PER_MPH;
+        if (unit.compare(QLatin1String("knots"), Qt::CaseInsensitive) == 0) return number * KMH_PER_KNOT;
+        return DEFAULT_MAX_SPEED_KMH;
+    }
 
-            qint64 wayId = static_cast<qint64>(way.id());
+    // Pas de limitation (autoroutes allemandes) : vitesse conseillée
+    if (value == QLatin1String("none")) return 130.0;
 
-            RoadEdge forward;
-            forward.id = (wayId << 16) + static_cast<qint64>(i);
-            forward.fromNode = fromIndex;
-            forward.toNode = toIndex;
-            forward.lengthMeters = length;
-            forward.oneway = oneway && !reverseOneway;
-            forward.maxSpeedKmh = maxSpeed;
-            forward.highwayType = highwayType;
+    for (const ImplicitMaxSpeed& entry : COUNTRY_MAX_SPEEDS) {
+        if (value == QLatin1String(entry.value)) return entry.kmh;
+    }
+    qsizetype separator = -1;
+    for (qsizetype i = 0; i < value.size(); ++i) {
+        if (value.at(i).unicode() == u':') {
+            separator = i;
+            break;
+        }
+    }
+    if (separator < 0) return DEFAULT_MAX_SPEED_KMH;
+    View zone = value.mid(separator + 1);
+
+    // Zones à vitesse explicite : "zone30", "zone:30"
+    if (zone.startsWith(QLatin1String("zone"))) {
+        zone = zone.mid(4);
+        if (!zone.isEmpty() && zone.at(0).unicode() == u':') zone = zone.mid(1);
+        qsizetype end = -1;
+        const double zoneSpeed = parseLeadingNumber(zone, end);
+        return end == zone.size() ? zoneSpeed : DEFAULT_MAX_SPEED_KMH;
+    }
+    for (const ImplicitMaxSpeed& entry : ZONE_MAX_SPEEDS) {
+        if (zone == QLatin1String(entry.value)) return entry.kmh;
+    }
+    return DEFAULT_MAX_SPEED_KMH;
+}
 
-            if (!reverseOneway) {
-                m_graph.addEdge(forward);
-            }
+template <typename View>
+OnewayDirection onewayDirectionFromValue(View value) {
+    if (value == QLatin1String("yes") || value == QLatin1String("true") || value == QLatin1String("1")) {
+        return OnewayDirection::Forward;
+    }
+    if (value == QLatin1String("-1") || value == QLatin1String("reverse")) {
+        return OnewayDirection::Reverse;
+    }
+    // "no", mais aussi "reversible" ou "alternating" : les deux sens restent ouverts
+    return OnewayDirection::No;
+}
 
-            if (!oneway || reverseOneway) {
-                RoadEdge backward = forward;
-                backward.id = (wayId << 16) + static_cast<qint64>(i) + static_cast<qint64>(nodes.size());
-                backward.fromNode = toIndex;
-                backward.toNode = fromIndex;
-                backward.oneway = oneway && reverseOneway;
-                if (reverseOneway) {
-                    m_graph.addEdge(backward);
-                } else if (!oneway) {
-                    backward.oneway = false;
-                    m_graph.addEdge(backward);
-                }
-            }
+// Tags d'une voie utiles au graphe, convertis dès leur lecture : aucune
+// valeur n'est conservée sous forme de chaîne
+struct WayTags {
+    HighwayClass highwayClass = HighwayClass::Unsupported;
+    OnewayDirection oneway = OnewayDirection::Unspecified;
+    bool roundabout = false; // junction=roundabout ou circular : sens unique implicite
+    double maxSpeedKmh = DEFAULT_MAX_SPEED_KMH;
+
+    template <typename View>
+    void read(View key, View value) {
+        if (key == QLatin1String("highway")) {
+            highwayClass = highwayClassFromName(value);
+        } else if (key == QLatin1String("oneway")) {
+            oneway = onewayDirectionFromValue(value);
+        } else if (key == QLatin1String("maxspeed")) {
+            maxSpeedKmh = parseMaxSpeedKmh(value);
+        } else if (key == QLatin1String("junction")) {
+            roundabout = value == QLatin1String("roundabout") || value == QLatin1String("circular");
         }
     }
 
-private:
-    int ensureNode(const osmium::WayNodeRef& ref) {
-        qint64 id = static_cast<qint64>(ref.ref());
-        int idx = m_graph.nodeIndex(id);
-        if (idx >= 0) {
-            return idx;
-        }
-        if (!ref.location().valid()) {
-            return -1;
-        }
-        RoadNode node;
-        node.id = id;
-        node.lat = ref.location().lat();
-        node.lon = ref.location().lon();
-        return m_graph.addNode(node);
+    bool isReverseOneway() const { return oneway == OnewayDirection::Reverse; }
+    bool isOneway() const {
+        return oneway == OnewayDirection::Forward || oneway == OnewayDirection::Reverse
+               || (oneway == OnewayDirection::Unspecified && roundabout);
     }
 
-    RoadGraph& m_graph;
+    WayAttributes attributes(qint64 wayId) const {
+        WayAttributes result;
+        result.wayId = wayId;
+        result.maxSpeedKmh = maxSpeedKmh;
+        result.highwayClass = highwayClass;
+        result.oneway = isOneway();
+        return result;
+    }
 };
 
-bool loadFromOsmPbf(const QString& filePath, RoadGraph& graph, QString* errorMessage) {
-    try {
-        graph.clear();
+constexpr int PROGRESS_ELEMENT_INTERVAL = 1 << 14; // Éléments XML entre deux points de progression et d'annulation
 
-        osmium::io::Reader reader(filePath.toStdString(), osmium::osm_entity_bits::node | osmium::osm_entity_bits::way);
+bool isCancelRequested(const RoadGraphLoader::Options& options) {
+    return options.cancelRequested && options.cancelRequested->load(std::memory_order_relaxed);
+}
 
-        using index_type = osmium::index::map::SparseMemArray<osmium::unsigned_object_id_type, osmium::Location>;
-        using location_handler_type = osmium::handler::node_locations_for_ways<index_type>;
+bool failCanceled(QString* errorMessage) {
+    if (errorMessage) {
+        *errorMessage = QStringLiteral("Chargement annulé");
+    }
+    return false;
+}
 
-        index_type index;
-        location_handler_type locationHandler(index);
-        locationHandler.ignore_errors();
+// Fin de chargement commune aux formats XML et PBF. La fusion des chaînes passe
+// avant la renumérotation : l'ordre de Hilbert porte ainsi sur les arêtes finales,
+// et adjacence, géométrie et tables d'identifiants ne sont construites qu'une fois.
+void finishGraph(RoadGraph& graph, const RoadGraphLoader::Options& options) {
+    if (options.contractDegreeTwoChains) {
+        const int removedEdges = graph.contractDegreeTwoChains();
+        qInfo() << "Chaînes de degré 2 fusionnées:" << removedEdges << "arêtes en moins,"
+                << graph.edges().size() << "restantes";
+    }
+    graph.reorderForLocality();
+    graph.buildAdjacency();
+    graph.buildGeometry();
+}
 
-        RoadGraphBuilderHandler handler(graph);
+struct NodeCoordinates {
+    double lat = 0.0;
+    double lon = 0.0;
+};
 
-        osmium::apply(reader, locationHandler, handler);
-        reader.close();
+// Coordonnées de tous les nœuds du fichier en tableaux triés par identifiant
+// (recherche dichotomique) : bien plus compact qu'une table de hachage, et les
+// fichiers OSM listent déjà leurs nœuds par identifiant croissant
+class NodeCoordinateIndex {
+public:
+    void append(qint64 id, double lat, double lon) {
+        if (!m_ids.isEmpty() && id <= m_ids.last()) {
+            m_sorted = false;
+        }
+        m_ids.append(id);
+        m_coordinates.append(NodeCoordinates{lat, lon});
+    }
 
-        return true;
-    } catch (const std::exception& ex) {
-        if (errorMessage) {
-            *errorMessage = QStringLiteral("Erreur libosmium: %1").arg(QString::fromUtf8(ex.what()));
+    // À appeler une fois la lecture terminée, avant find()
+    void finish() {
+        if (m_sorted) return;
+        QVector<int> order(m_ids.size());
+        for (int i = 0; i < order.size(); ++i) {
+            order[i] = i;
         }
-        return false;
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return m_ids.at(a) < m_ids.at(b); });
+        QVector<qint64> ids(m_ids.size());
+        QVector<NodeCoordinates> coordinates(m_coordinates.size());
+        for (int i = 0; i < order.size(); ++i) {
+            ids[i] = m_ids.at(order.at(i));
+            coordinates[i] = m_coordinates.at(order.at(i));
+        }
+        m_ids = ids;
+        m_coordinates = coordinates;
+        m_sorted = true;
     }
-}
-#endif
 
-double parseMaxSpeedKmh(const QString& value) {
-    if (value.isEmpty()) return 50.0;
-    QString cleaned = value.trimmed().toLower();
-    QRegularExpression regex("^(\\d+(?:\\.\\d+)?)(?:\\s*(km/h|kmh|mph|kph))?$");
-    QRegularExpressionMatch match = regex.match(cleaned);
-    if (!match.hasMatch()) return 50.0;
-    double speed = match.captured(1).toDouble();
-    QString unit = match.captured(2);
-    if (unit == "mph") {
-        speed *= 1.60934;
+    const NodeCoordinates* find(qint64 id) const {
+        auto it = std::lower_bound(m_ids.constBegin(), m_ids.constEnd(), id);
+        if (it == m_ids.constEnd() || *it != id) return nullptr;
+        return &m_coordinates.at(static_cast<int>(it - m_ids.constBegin()));
     }
-    return speed;
+
+private:
+    QVector<qint64> m_ids;
+    QVector<NodeCoordinates> m_coordinates;
+    bool m_sorted = true;
+};
+
+// Voie routière retenue pendant la lecture ; ses références de nœuds sont
+// stockées à la suite dans un tableau commun
+struct PendingWay {
+    WayAttributes attributes;
+    bool reverseOneway = false;
+    int firstRef = 0;
+    int refCount = 0;
+};
+
+// Nœud du graphe pour l'identifiant OSM id, créé à la première référence
+int ensureRoadNode(RoadGraph& graph, qint64 id, const NodeCoordinates& coordinates) {
+    int index = graph.nodeIndex(id);
+    if (index >= 0) return index;
+    RoadNode node;
+    node.id = id;
+    node.lat = coordinates.lat;
+    node.lon = coordinates.lon;
+    return graph.addNode(node);
 }
-} // namespace
 
-bool RoadGraphLoader::loadFromOsmFile(const QString& filePath, RoadGraph& graph, QString* errorMessage) {
-    QString lower = QFileInfo(filePath).suffix().toLower();
-    if (lower == QLatin1String("pbf") || filePath.toLower().endsWith(".osm.pbf")) {
-#ifdef HAVE_LIBOSMIUM
-        return loadFromOsmPbf(filePath, graph, errorMessage);
-#else
-        if (errorMessage) {
-            *errorMessage = QStringLiteral("Support des fichiers .pbf indisponible (libosmium non détecté).");
-        }
-        return false;
-#endif
+// Arêtes du segment wayNodeIndex -> wayNodeIndex + 1 d'une voie selon son sens de circulation
+void addRoadEdges(RoadGraph& graph, const WayAttributes& attributes, int attributeIndex, bool reverseOneway,
+                  int wayNodeIndex, int wayNodeCount, int fromIndex, int toIndex, double lengthMeters) {
+    const qint64 wayId = attributes.wayId;
+    RoadEdge forward;
+    forward.id = (wayId << 16) + wayNodeIndex;
+    forward.fromNode = fromIndex;
+    forward.toNode = toIndex;
+    forward.lengthMeters = lengthMeters;
+    forward.attributeIndex = attributeIndex;
+
+    if (!reverseOneway) {
+        graph.addEdge(forward);
     }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        if (errorMessage) {
-            *errorMessage = QStringLiteral("Impossible d'ouvrir le fichier OSM: %1").arg(file.errorString());
-        }
-        return false;
+    if (!attributes.oneway || reverseOneway) {
+        RoadEdge backward = forward;
+        backward.id = (wayId << 16) + wayNodeIndex + wayNodeCount;
+        backward.fromNode = toIndex;
+        backward.toNode = fromIndex;
+        // oneway=-1 : seule l'arête inverse est conservée
+        graph.addEdge(backward);
     }
-    QByteArray data = file.readAll();
-    return loadFromOsmData(data, graph, errorMessage);
 }
 
-bool RoadGraphLoader::loadFromOsmData(const QByteArray& data, RoadGraph& graph, QString* errorMessage) {
+// Lecture en une seule passe : coordonnées de tous les nœuds, attributs et
+// références des seules voies retenues. Les nœuds du graphe ne sont créés
+// qu'ensuite, pour ceux que ces voies référencent (bâtiments, points d'intérêt
+// et limites administratives sont ignorés).
+bool loadFromOsmXml(QXmlStreamReader& xml, RoadGraph& graph, const RoadGraphLoader::Options& options,
+                    QString* errorMessage) {
     graph.clear();
 
-    struct NodeInfo {
-        double lat = 0.0;
-        double lon = 0.0;
-    };
-
-    QHash<qint64, NodeInfo> nodesTmp;
-
-    QXmlStreamReader xmlNodes(data);
+    NodeCoordinateIndex nodeCoordinates;
+    QVector<PendingWay> ways;
+    QVector<qint64> wayNodeRefs;
+    const qint64 totalBytes = xml.device() ? xml.device()->size() : 0;
+    int elementCount = 0;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement()) continue;
+        if (++elementCount % PROGRESS_ELEMENT_INTERVAL == 0) {
+            if (isCancelRequested(options)) return failCanceled(errorMessage);
+            if (options.progress && xml.device()) {
+                options.progress({xml.device()->pos(), totalBytes, ways.size()});
+            }
+        }
 
-    while (!xmlNodes.atEnd()) {
-        xmlNodes.readNext();
-        if (xmlNodes.isStartElement() && xmlNodes.name() == QLatin1String("node")) {
-            auto attrs = xmlNodes.attributes();
+        if (xml.name() == QLatin1String("node")) {
+            auto attrs = xml.attributes();
             bool okId = false;
             qint64 id = attrs.value("id").toLongLong(&okId);
             if (!okId) continue;
-            double lat = attrs.value("lat").toDouble();
-            double lon = attrs.value("lon").toDouble();
-            nodesTmp.insert(id, NodeInfo{lat, lon});
+            nodeCoordinates.append(id, attrs.value("lat").toDouble(), attrs.value("lon").toDouble());
+        } else if (xml.name() == QLatin1String("way")) {
+            qint64 wayId = xml.attributes().value("id").toLongLong();
+            const int firstRef = wayNodeRefs.size();
+            WayTags tags;
+
+            while (!xml.atEnd()) {
+                xml.readNext();
+                if (xml.isEndElement() && xml.name() == QLatin1String("way")) break;
+                if (!xml.isStartElement()) continue;
+                if (xml.name() == QLatin1String("nd")) {
+                    bool okRef = false;
+                    qint64 ref = xml.attributes().value("ref").toLongLong(&okRef);
+                    if (okRef) wayNodeRefs.append(ref);
+                } else if (xml.name() == QLatin1String("tag")) {
+                    auto attrs = xml.attributes();
+                    tags.read(attrs.value("k"), attrs.value("v"));
+                }
+            }
+
+            if (tags.highwayClass == HighwayClass::Unsupported) {
+                wayNodeRefs.resize(firstRef);
+                continue;
+            }
+
+            PendingWay way;
+            way.attributes = tags.attributes(wayId);
+            way.reverseOneway = tags.isReverseOneway();
+            way.firstRef = firstRef;
+            way.refCount = wayNodeRefs.size() - firstRef;
+            ways.append(way);
+        } else if (xml.name() == QLatin1String("relation")) {
+            // Les relations ne contribuent pas au graphe routier
+            xml.skipCurrentElement();
         }
     }
 
-    if (xmlNodes.hasError()) {
+    if (isCancelRequested(options)) return failCanceled(errorMessage);
+    if (xml.hasError()) {
         if (errorMessage) {
-            *errorMessage = QStringLiteral("Erreur lors de la lecture des nœuds OSM: %1").arg(xmlNodes.errorString());
+            *errorMessage = QStringLiteral("Erreur lors de la lecture du fichier OSM: %1").arg(xml.errorString());
         }
         return false;
     }
 
-    for (auto it = nodesTmp.constBegin(); it != nodesTmp.constEnd(); ++it) {
-        RoadNode node;
-        node.id = it.key();
-        node.lat = it.value().lat;
-        node.lon = it.value().lon;
-        graph.addNode(node);
+    nodeCoordinates.finish();
+    for (const PendingWay& way : std::as_const(ways)) {
+        int attributeIndex = graph.addWayAttributes(way.attributes);
+
+        for (int i = 0; i < way.refCount - 1; ++i) {
+            qint64 fromId = wayNodeRefs.at(way.firstRef + i);
+            qint64 toId = wayNodeRefs.at(way.firstRef + i + 1);
+
+            const NodeCoordinates* from = nodeCoordinates.find(fromId);
+            const NodeCoordinates* to = nodeCoordinates.find(toId);
+            if (!from || !to) continue;
+
+            int fromIndex = ensureRoadNode(graph, fromId, *from);
+            int toIndex = ensureRoadNode(graph, toId, *to);
+            double length = Proximity::haversineMeters(from->lat, from->lon, to->lat, to->lon);
+            addRoadEdges(graph, way.attributes, attributeIndex, way.reverseOneway, i, way.refCount,
+                         fromIndex, toIndex, length);
+        }
     }
 
-    QXmlStreamReader xmlWays(data);
-
-    while (!xmlWays.atEnd()) {
-        xmlWays.readNext();
-        if (xmlWays.isStartElement() && xmlWays.name() == QLatin1String("way")) {
-            QHash<QString, QString> tags;
-            QVector<qint64> nodeRefs;
-            qint64 wayId = xmlWays.attributes().value("id").toLongLong();
-
-            while (!(xmlWays.isEndElement() && xmlWays.name() == QLatin1String("way"))) {
-                xmlWays.readNext();
-                if (xmlWays.isStartElement()) {
-                    if (xmlWays.name() == QLatin1String("nd")) {
-                        bool okRef = false;
-                        qint64 ref = xmlWays.attributes().value("ref").toLongLong(&okRef);
-                        if (okRef) nodeRefs.append(ref);
-                    } else if (xmlWays.name() == QLatin1String("tag")) {
-                        QString k = xmlWays.attributes().value("k").toString();
-                        QString v = xmlWays.attributes().value("v").toString();
-                        tags.insert(k, v);
-                    }
-                }
-            }
+    // Les nœuds sont créés dans l'ordre de parcours des voies : renumérotation spatiale
+    finishGraph(graph, options);
+    if (options.progress && xml.device()) {
+        options.progress({totalBytes, totalBytes, ways.size()});
+    }
+    return true;
+}
 
-            QString highwayType = tags.value("highway");
-            if (!isHighwayTypeSupported(highwayType)) {
-                continue;
-            }
+#ifdef HAVE_LIBOSMIUM
+constexpr int PBF_BUFFERS_PER_THREAD = 4; // Blocs PBF accumulés par thread avant construction des arêtes
+
+// Voie routière d'un bloc PBF ; ses segments sont à la suite dans PbfWayBatch::segments
+struct PbfWay {
+    WayAttributes attributes;
+    bool reverseOneway = false;
+    int wayNodeCount = 0;
+    int firstSegment = 0;
+    int segmentCount = 0;
+};
 
-            QString onewayTag = tags.value("oneway");
-            bool oneway = isOnewayValueTrue(onewayTag) || onewayTag == QLatin1String("-1");
-            bool reverseOneway = onewayTag == QLatin1String("-1");
-            double maxSpeed = parseMaxSpeedKmh(tags.value("maxspeed"));
+// Segment entre deux nœuds consécutifs d'une voie, positions résolues
+struct PbfSegment {
+    int wayNodeIndex = 0;
+    qint64 fromId = 0;
+    qint64 toId = 0;
+    NodeCoordinates from;
+    NodeCoordinates to;
+    double lengthMeters = 0.0;
+};
 
-            for (int i = 0; i < nodeRefs.size() - 1; ++i) {
-                qint64 fromId = nodeRefs[i];
-                qint64 toId = nodeRefs[i + 1];
+struct PbfWayBatch {
+    QVector<PbfWay> ways;
+    QVector<PbfSegment> segments;
+};
 
-                const RoadNode* fromNode = graph.nodeById(fromId);
-                const RoadNode* toNode = graph.nodeById(toId);
-                if (!fromNode || !toNode) continue;
+// Voies routières d'un bloc dont les positions de nœuds ont été renseignées.
+// Ne touche pas au graphe : plusieurs blocs sont traités en parallèle.
+void collectRoadWays(const osmium::memory::Buffer& buffer, PbfWayBatch& batch) {
+    for (const osmium::Way& way : buffer.select<osmium::Way>()) {
+        WayTags tags;
+        for (const osmium::Tag& tag : way.tags()) {
+            tags.read(QLatin1String(tag.key()), QLatin1String(tag.value()));
+        }
+        if (tags.highwayClass == HighwayClass::Unsupported) continue;
 
-                int fromIndex = graph.nodeIndex(fromId);
-                int toIndex = graph.nodeIndex(toId);
-                if (fromIndex < 0 || toIndex < 0) continue;
+        PbfWay pending;
+        pending.attributes = tags.attributes(static_cast<qint64>(way.id()));
+        pending.reverseOneway = tags.isReverseOneway();
 
-                double length = haversine(fromNode->lat, fromNode->lon, toNode->lat, toNode->lon);
+        const auto& nodes = way.nodes();
+        pending.wayNodeCount = static_cast<int>(nodes.size());
+        pending.firstSegment = batch.segments.size();
+        for (std::size_t i = 0; i + 1 < nodes.size(); ++i) {
+            const osmium::Location from = nodes[i].location();
+            const osmium::Location to = nodes[i + 1].location();
+            if (!from.valid() || !to.valid()) continue;
+
+            PbfSegment segment;
+            segment.wayNodeIndex = static_cast<int>(i);
+            segment.fromId = static_cast<qint64>(nodes[i].ref());
+            segment.toId = static_cast<qint64>(nodes[i + 1].ref());
+            segment.from = NodeCoordinates{from.lat(), from.lon()};
+            segment.to = NodeCoordinates{to.lat(), to.lon()};
+            segment.lengthMeters = Proximity::haversineMeters(from.lat(), from.lon(), to.lat(), to.lon());
+            batch.segments.append(segment);
+        }
+        pending.segmentCount = batch.segments.size() - pending.firstSegment;
+        batch.ways.append(pending);
+    }
+}
 
-                RoadEdge forward;
-                forward.id = (wayId << 16) + i;
-                forward.fromNode = fromIndex;
-                forward.toNode = toIndex;
-                forward.lengthMeters = length;
-                forward.oneway = oneway && !reverseOneway;
-                forward.maxSpeedKmh = maxSpeed;
-                forward.highwayType = highwayType;
+// Fusion séquentielle dans le graphe, dans l'ordre du fichier
+void mergeWayBatch(const PbfWayBatch& batch, RoadGraph& graph) {
+    for (const PbfWay& way : batch.ways) {
+        int attributeIndex = graph.addWayAttributes(way.attributes);
+        for (int s = way.firstSegment; s < way.firstSegment + way.segmentCount; ++s) {
+            const PbfSegment& segment = batch.segments.at(s);
+            int fromIndex = ensureRoadNode(graph, segment.fromId, segment.from);
+            int toIndex = ensureRoadNode(graph, segment.toId, segment.to);
+            addRoadEdges(graph, way.attributes, attributeIndex, way.reverseOneway, segment.wayNodeIndex,
+                         way.wayNodeCount, fromIndex, toIndex, segment.lengthMeters);
+        }
+    }
+}
 
-                if (!reverseOneway && forward.fromNode >= 0 && forward.toNode >= 0) {
-                    graph.addEdge(forward);
-                }
+// Décodage des blocs par le pool de libosmium ; positions des nœuds dans index
+// (séquentiel : les nœuds précèdent les voies), puis extraction des voies par
+// lots de blocs répartis sur le pool de threads et fusion dans l'ordre du fichier
+// Retourne false si le chargement a été annulé
+template <typename TIndex>
+bool readPbf(const QString& filePath, RoadGraph& graph, TIndex& index, const RoadGraphLoader::Options& options) {
+    osmium::handler::NodeLocationsForWays<TIndex> locationHandler(index);
+    locationHandler.ignore_errors();
+
+    ThreadPool pool(options.workerCount);
+    osmium::thread::Pool decodePool(pool.threadCount());
+    osmium::io::Reader reader(osmium::io::File(filePath.toStdString()),
+                              osmium::osm_entity_bits::node | osmium::osm_entity_bits::way,
+                              osmium::io::read_meta::no, decodePool);
+    const qint64 totalBytes = static_cast<qint64>(reader.file_size());
+
+    const std::size_t batchSize = static_cast<std::size_t>(pool.threadCount() * PBF_BUFFERS_PER_THREAD);
+    std::vector<osmium::memory::Buffer> pending;
+    QVector<PbfWayBatch> batches;
+    qint64 wayCount = 0;
+    auto flush = [&]() {
+        batches.clear();
+        batches.resize(static_cast<int>(pending.size()));
+        pool.parallelFor(0, static_cast<int>(pending.size()), 1, [&](int begin, int end) {
+            for (int b = begin; b < end; ++b) {
+                collectRoadWays(pending[b], batches[b]);
+            }
+        });
+        for (const PbfWayBatch& batch : std::as_const(batches)) {
+            mergeWayBatch(batch, graph);
+            wayCount += batch.ways.size();
+        }
+        pending.clear();
+    };
 
-                if (!oneway || reverseOneway) {
-                    RoadEdge backward = forward;
-                    backward.id = (wayId << 16) + i + nodeRefs.size();
-                    backward.fromNode = toIndex;
-                    backward.toNode = fromIndex;
-                    backward.oneway = oneway && reverseOneway;
-                    if (reverseOneway) {
-                        // oneway in reverse direction, so only keep backward edge
-                        graph.addEdge(backward);
-                    } else if (!oneway) {
-                        backward.oneway = false;
-                        graph.addEdge(backward);
+    while (osmium::memory::Buffer buffer = reader.read()) {
+        if (isCancelRequested(options)) {
+            reader.close();
+            return false;
+        }
+        osmium::apply(buffer, locationHandler);
+        pending.push_back(std::move(buffer));
+        if (pending.size() >= batchSize) {
+            flush();
+        }
+        if (options.progress) {
+            options.progress({static_cast<qint64>(reader.offset()), totalBytes, wayCount});
+        }
+    }
+    flush();
+    reader.close();
+    return true;
+}
+
+bool loadFromOsmPbf(const QString& filePath, RoadGraph& graph, const RoadGraphLoader::Options& options,
+                    QString* errorMessage) {
+    try {
+        graph.clear();
+
+        RoadGraphLoader::LocationIndex locationIndex = options.locationIndex;
+        if (locationIndex == RoadGraphLoader::LocationIndex::Automatic) {
+            locationIndex = QFileInfo(filePath).size() >= options.denseIndexThresholdBytes
+                                ? RoadGraphLoader::LocationIndex::DenseFile
+                                : RoadGraphLoader::LocationIndex::SparseMemory;
+        }
+
+        if (locationIndex == RoadGraphLoader::LocationIndex::DenseFile) {
+            // Fichier d'index à côté de la source plutôt que dans le répertoire
+            // temporaire, souvent en mémoire
+            QTemporaryFile indexFile(QDir(QFileInfo(filePath).absolutePath())
+                                         .filePath(QStringLiteral(".v2v-locations-XXXXXX")));
+            if (!indexFile.open()) {
+                indexFile.setFileTemplate(QDir::temp().filePath(QStringLiteral("v2v-locations-XXXXXX")));
+                if (!indexFile.open()) {
+                    if (errorMessage) {
+                        *errorMessage = QStringLiteral("Impossible de créer l'index des positions: %1")
+                                            .arg(indexFile.errorString());
                     }
+                    return false;
                 }
             }
+            osmium::index::map::DenseFileArray<osmium::unsigned_object_id_type, osmium::Location> index(
+                indexFile.handle());
+            if (!readPbf(filePath, graph, index, options)) {
+                graph.clear();
+                return failCanceled(errorMessage);
+            }
+        } else {
+            osmium::index::map::SparseMemArray<osmium::unsigned_object_id_type, osmium::Location> index;
+            if (!readPbf(filePath, graph, index, options)) {
+                graph.clear();
+                return failCanceled(errorMessage);
+            }
+        }
+
+        finishGraph(graph, options);
+        return true;
+    } catch (const std::exception& ex) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Erreur libosmium: %1").arg(QString::fromUtf8(ex.what()));
         }
+        return false;
     }
+}
+#endif
+} // namespace
+
+bool RoadGraphLoader::loadFromOsmFile(const QString& filePath, RoadGraph& graph, QString* errorMessage) {
+    return loadFromOsmFile(filePath, graph, Options(), errorMessage);
+}
 
-    if (xmlWays.hasError()) {
+bool RoadGraphLoader::loadFromOsmFile(const QString& filePath, RoadGraph& graph, const Options& options,
+                                      QString* errorMessage) {
+    QString lower = QFileInfo(filePath).suffix().toLower();
+    if (lower == QLatin1String("pbf") || filePath.toLower().endsWith(".osm.pbf")) {
+#ifdef HAVE_LIBOSMIUM
+        return loadFromOsmPbf(filePath, graph, options, errorMessage);
+#else
         if (errorMessage) {
-            *errorMessage = QStringLiteral("Erreur lors de la lecture des routes OSM: %1").arg(xmlWays.errorString());
+            *errorMessage = QStringLiteral("Support des fichiers .pbf indisponible (libosmium non détecté).");
         }
         return false;
+#endif
     }
 
-    return true;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Impossible d'ouvrir le fichier OSM: %1").arg(file.errorString());
+        }
+        return false;
+    }
+    // Lecture au fil du fichier, sans le charger entièrement en mémoire
+    QXmlStreamReader xml(&file);
+    return loadFromOsmXml(xml, graph, options, errorMessage);
 }
 
+bool RoadGraphLoader::loadFromOsmData(const QByteArray& data, RoadGraph& graph, QString* errorMessage) {
+    QXmlStreamReader xml(data);
+    return loadFromOsmXml(xml, graph, Options(), errorMessage);
+}
@@ -3,12 +3,45 @@
 #include <QObject>
 #include <QString>
 
+#include <atomic>
+#include <functional>
+
 class RoadGraph;
 
 class RoadGraphLoader {
 public:
+    // Avancement du chargement
+    struct LoadProgress {
+        qint64 processedBytes = 0; // Octets du fichier source lus
+        qint64 totalBytes = 0;
+        qint64 wayCount = 0;       // Voies routières retenues jusqu'ici
+    };
+    // Appelé depuis le thread qui charge
+    using ProgressCallback = std::function<void(const LoadProgress& progress)>;
+
+    // Index des positions de nœuds pendant la lecture d'un .osm.pbf
+    enum class LocationIndex {
+        Automatic,    // DenseFile à partir de denseIndexThresholdBytes, SparseMemory en deçà
+        SparseMemory, // Tableau trié en mémoire, adapté aux extraits régionaux
+        DenseFile     // Tableau indexé par identifiant, projeté depuis un fichier temporaire
+    };
+
+    struct Options {
+        int workerCount = 0; // Décodage PBF et construction des arêtes ; <= 0 : un thread par cœur
+        LocationIndex locationIndex = LocationIndex::Automatic;
+        qint64 denseIndexThresholdBytes = Q_INT64_C(1) << 30;
+        // Fusionne les chaînes de degré 2 en arêtes en polyligne avant la
+        // renumérotation spatiale (RoadGraph::contractDegreeTwoChains)
+        bool contractDegreeTwoChains = false;
+        ProgressCallback progress;
+        // Positionné depuis un autre thread pour interrompre la lecture : le
+        // chargement échoue alors avec un message d'annulation
+        const std::atomic<bool>* cancelRequested = nullptr;
+    };
+
     // Supporte les fichiers .osm (XML) et .osm.pbf (binaire) si libosmium est disponible.
     static bool loadFromOsmFile(const QString& filePath, RoadGraph& graph, QString* errorMessage = nullptr);
+    static bool loadFromOsmFile(const QString& filePath, RoadGraph& graph, const Options& options,
+                                QString* errorMessage = nullptr);
     static bool loadFromOsmData(const QByteArray& data, RoadGraph& graph, QString* errorMessage = nullptr);
 };
-
@@ -0,0 +1,593 @@
+#include "SimulationEngine.h"
+
+#include <QtMath>
+#include <QDebug>
+#include <QVarLengthArray>
+#include <QtAlgorithms>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+void SimulationEngine::setRoadGraph(RoadGraph graph, const QString& hierarchyCachePath) {
+    m_roadGraph = std::move(graph);
+    m_hierarchyCachePath = hierarchyCachePath;
+    if (!m_roadGraph.hasAdjacency()) {
+        m_roadGraph.buildAdjacency();
+    }
+    if (!m_roadGraph.hasGeometry()) {
+        m_roadGraph.buildGeometry();
+    }
+    m_roadGraphLoaded = true;
+    m_vehicles.clear();
+    m_edgeOccupancy.clear();
+    m_neighborLists.clear();
+    m_messages.clear();
+    m_alertPropagation.clear();
+    m_timeAccumulator = 0.0;
+    m_simulationTimeSeconds = 0.0;
+    m_simulationTimeMs = 0;
+    m_events.clear();
+    if (m_routingEnabled) {
+        ensureContractionHierarchy();
+    }
+}
+
+SimulationSnapshot SimulationEngine::snapshot() const {
+    SimulationSnapshot snap;
+    snap.simulationTimeMs = m_simulationTimeMs;
+    snap.vehicles = m_vehicles.toVehicles(m_roadGraph.localFrame());
+    for (int i = 0; i < snap.vehicles.size(); ++i) {
+        for (const V2VMessage& message : m_messages.inbox(i)) {
+            snap.vehicles[i].addMessageToInbox(message);
+        }
+    }
+    snap.lastAlert = m_alertPropagation.lastResult();
+    return snap;
+}
+
+void SimulationEngine::setFixedTimeStep(double seconds) {
+    if (seconds > 0.0) {
+        m_fixedTimeStep = seconds;
+    }
+}
+
+int SimulationEngine::runFor(double simSeconds) {
+    if (simSeconds <= 0.0) return 0;
+
+    m_timeAccumulator += simSeconds;
+    int steps = 0;
+    while (m_timeAccumulator >= m_fixedTimeStep) {
+        step(m_fixedTimeStep);
+        m_timeAccumulator -= m_fixedTimeStep;
+        ++steps;
+    }
+    return steps;
+}
+
+void SimulationEngine::step(double deltaTimeSeconds) {
+    if (!m_roadGraphLoaded || deltaTimeSeconds <= 0.0) return;
+
+    m_simulationTimeSeconds += deltaTimeSeconds;
+    m_simulationTimeMs = static_cast<qint64>(std::llround(m_simulationTimeSeconds * 1000.0));
+
+    updateVehiclePositions(deltaTimeSeconds);
+    m_edgeOccupancy.update(m_vehicles);
+    // Nouveaux itinéraires pour les véhicules arrivés à destination
+    assignRoutes();
+    m_neighborLists.update(m_vehicles);
+
+    // Messages CAM arrivés à échéance (chaque véhicule a sa propre phase)
+    processDueEvents();
+
+    // Détecter les arrêts brutaux pour déclencher des alertes
+    detectEmergencyStop();
+
+    // Réception : chaque véhicule tire les messages de ses voisins à portée
+    deliverMessages();
+
+    // Comptabiliser les messages V2V reçus
+    processV2VMessages();
+
+    expireReceivedAlerts();
+}
+
+void SimulationEngine::generateVehicles(int count) {
+    m_vehicles.clear();
+    m_edgeOccupancy.clear();
+    m_neighborLists.clear();
+    m_messages.clear();
+    m_alertPropagation.clear();
+    m_routeAssignmentCount = 0;
+    if (!m_roadGraphLoaded) return;
+    m_vehicles.reserve(count);
+
+    const auto& edges = m_roadGraph.edges();
+    const auto& nodes = m_roadGraph.nodes();
+    if (edges.isEmpty() || nodes.isEmpty()) return;
+
+    // Flux 0 réservé au placement ; les véhicules utilisent le flux de leur ID
+    RandomStream spawnRng = RandomStream::forStream(m_seed, 0);
+
+    // Créer une liste d'arêtes valides
+    QVector<int> validEdgeIndices;
+    for (int i = 0; i < edges.size(); ++i) {
+        const RoadEdge& edge = edges.at(i);
+        if (edge.fromNode >= 0 && edge.toNode >= 0 &&
+            edge.fromNode < nodes.size() && edge.toNode < nodes.size()) {
+            validEdgeIndices.append(i);
+        }
+    }
+
+    if (validEdgeIndices.isEmpty()) {
+        qWarning() << "Aucune arête valide trouvée pour générer des véhicules";
+        return;
+    }
+
+    // Pour éviter de mettre plusieurs véhicules trop proches sur la même arête,
+    // les véhicules placés sont inscrits au fur et à mesure dans l'occupation des arêtes
+    m_edgeOccupancy.reset(m_roadGraph);
+
+    int vehicleId = 1;
+    int attempts = 0;
+    const int maxAttempts = count * 50; // Limite pour éviter boucle infinie
+    const double minDistanceOnEdge = 0.05; // Distance minimale entre véhicules sur la même arête (5%)
+
+    while (vehicleId <= count && attempts < maxAttempts) {
+        attempts++;
+
+        // Sélectionner une arête aléatoire
+        int randomEdgeIdx = validEdgeIndices.at(spawnRng.bounded(validEdgeIndices.size()));
+        const RoadEdge& edge = edges.at(randomEdgeIdx);
+        const WayAttributes& attributes = m_roadGraph.edgeAttributes(randomEdgeIdx);
+
+        const RoadNode& fromNode = nodes.at(edge.fromNode);
+        const RoadNode& toNode = nodes.at(edge.toNode);
+
+        // Générer une position aléatoire sur l'arête
+        double t = spawnRng.uniform();
+
+        // Vérifier que cette position n'est pas trop proche d'un autre véhicule sur la même arête
+        bool tooClose = false;
+        auto checkDistance = [&](int otherIndex) {
+            if (std::abs(t - m_vehicles.positionsOnEdge().at(otherIndex)) < minDistanceOnEdge) {
+                tooClose = true;
+            }
+        };
+        m_edgeOccupancy.forEachOnLane(randomEdgeIdx, true, checkDistance);
+        m_edgeOccupancy.forEachOnLane(randomEdgeIdx, false, checkDistance);
+
+        if (tooClose) {
+            continue; // Essayer une autre position
+        }
+
+        // Calculer les coordonnées géographiques
+        double lat = fromNode.lat + (toNode.lat - fromNode.lat) * t;
+        double lon = fromNode.lon + (toNode.lon - fromNode.lon) * t;
+
+        Vehicle vehicle;
+        vehicle.setId(vehicleId);
+        vehicle.setRng(RandomStream::forStream(m_seed, static_cast<quint64>(vehicleId)));
+        vehicle.setLatLon(lat, lon);
+        vehicle.setSpeedKmh(attributes.maxSpeedKmh);
+        vehicle.setTransmissionRadiusMeters(spawnRng.uniform(100.0, 500.0));
+        vehicle.setEdgeIndex(randomEdgeIdx);
+        vehicle.setPositionOnEdge(t);
+        vehicle.setMovingForward(vehicle.rng().coin() || attributes.oneway);
+        // Période CAM propre au véhicule : les stations ne battent pas toutes à la même cadence
+        vehicle.setCamIntervalMs(CAM_INTERVAL_MS - CAM_INTERVAL_SPREAD_MS +
+                                 spawnRng.bounded(static_cast<int>(2 * CAM_INTERVAL_SPREAD_MS + 1)));
+
+        int vehicleIndex = m_vehicles.append(vehicle, m_roadGraph.edgeGeometry());
+
+        // Enregistrer cette position pour cette arête
+        m_edgeOccupancy.insert(vehicleIndex, m_vehicles);
+
+        ++vehicleId;
+    }
+
+    m_neighborLists.build(m_roadGraph, m_vehicles);
+    m_messages.reset(m_vehicles.size(), m_inboxCapacity);
+    scheduleCamEvents();
+    assignRoutes();
+
+    qInfo() << "Véhicules générés:" << m_vehicles.size() << "sur" << count << "demandés";
+}
+
+void SimulationEngine::updateVehiclePositions(double deltaTimeSeconds) {
+    // Les véhicules sont indépendants pendant le déplacement : chacun ne lit que
+    // le graphe (immuable) et n'écrit que ses propres champs, tirages aléatoires
+    // compris (flux par véhicule). Les blocs peuvent donc être traités en
+    // parallèle sans que le résultat dépende du nombre de threads.
+    m_threadPool.parallelFor(0, m_vehicles.size(), MOVEMENT_BLOCK_SIZE,
+                             [this, deltaTimeSeconds](int begin, int end) {
+        // 1. Progression sur l'arête (boucle vectorisable sur les champs chauds)
+        m_vehicles.advancePositions(deltaTimeSeconds, begin, end);
+
+        // 2. Transitions vers l'arête suivante (rares, traitées une par une)
+        for (int i = begin; i < end; ++i) {
+            if (m_vehicles.hasReachedEdgeEnd(i)) {
+                updateVehicleOnEdge(i);
+            }
+        }
+
+        // 3. Position métrique par interpolation sur l'arête
+        m_vehicles.interpolatePositions(m_roadGraph.edgeGeometry(), begin, end);
+    });
+}
+
+void SimulationEngine::updateVehicleOnEdge(int vehicleIndex) {
+    const auto& edges = m_roadGraph.edges();
+    const auto& nodes = m_roadGraph.nodes();
+
+    int currentEdgeIdx = m_vehicles.edgeIndices().at(vehicleIndex);
+    if (currentEdgeIdx < 0 || currentEdgeIdx >= edges.size()) return;
+
+    const RoadEdge& currentEdge = edges.at(currentEdgeIdx);
+    const bool wasMovingForward = m_vehicles.isMovingForward(vehicleIndex);
+    const double position = m_vehicles.positionsOnEdge().at(vehicleIndex);
+    int currentNodeIdx = wasMovingForward ? currentEdge.toNode : currentEdge.fromNode;
+
+    if (currentNodeIdx < 0 || currentNodeIdx >= nodes.size()) return;
+
+    VehicleState& state = m_vehicles.state(vehicleIndex);
+
+    // Trouver la prochaine arête : étape suivante de l'itinéraire si elle part du
+    // nœud atteint, sinon choix aléatoire à l'intersection
+    int nextEdgeIdx = -1;
+    bool movingForward = true;
+    if (state.routeCursor < state.route.size()) {
+        const RouteStep& routeStep = state.route.at(state.routeCursor);
+        const RoadEdge& routeEdge = edges.at(routeStep.edgeIndex);
+        if ((routeStep.forward ? routeEdge.fromNode : routeEdge.toNode) == currentNodeIdx) {
+            nextEdgeIdx = routeStep.edgeIndex;
+            movingForward = routeStep.forward;
+            ++state.routeCursor;
+        } else {
+            state.route.clear();
+            state.routeCursor = 0;
+        }
+    }
+    if (nextEdgeIdx < 0) {
+        nextEdgeIdx = selectNextEdge(currentNodeIdx, currentEdgeIdx, wasMovingForward, state.rng);
+        if (nextEdgeIdx >= 0 && nextEdgeIdx < edges.size()) {
+            // Déterminer la direction sur la nouvelle arête
+            movingForward = (edges.at(nextEdgeIdx).fromNode == currentNodeIdx);
+        }
+    }
+
+    if (nextEdgeIdx >= 0 && nextEdgeIdx < edges.size()) {
+        const RoadEdge& nextEdge = edges.at(nextEdgeIdx);
+
+        // Distance parcourue au-delà de l'extrémité, reportée sur la nouvelle arête
+        double overshoot = wasMovingForward ? position - 1.0 : -position;
+        double remainingMeters = std::max(overshoot, 0.0) * currentEdge.lengthMeters;
+
+        double newPosition = 0.0;
+        if (nextEdge.lengthMeters > 0) {
+            newPosition = std::clamp(remainingMeters / nextEdge.lengthMeters, 0.0, 1.0);
+        }
+        if (!movingForward) {
+            newPosition = 1.0 - newPosition;
+        }
+
+        m_vehicles.placeOnEdge(vehicleIndex, nextEdgeIdx, newPosition, movingForward,
+                               m_roadGraph.edgeAttributes(nextEdgeIdx).maxSpeedKmh, m_roadGraph.edgeGeometry());
+    } else {
+        // Pas de prochaine arête trouvée : faire demi-tour à l'extrémité atteinte
+        m_vehicles.placeOnEdge(vehicleIndex, currentEdgeIdx, wasMovingForward ? 1.0 : 0.0,
+                               !wasMovingForward, m_vehicles.speedKmh(vehicleIndex), m_roadGraph.edgeGeometry());
+    }
+}
+
+void SimulationEngine::setRoutingEnabled(bool enabled) {
+    m_routingEnabled = enabled;
+    if (!enabled) {
+        for (int i = 0; i < m_vehicles.size(); ++i) {
+            VehicleState& state = m_vehicles.state(i);
+            state.route.clear();
+            state.routeCursor = 0;
+            state.destinationNode = -1;
+        }
+        return;
+    }
+    ensureContractionHierarchy();
+    assignRoutes();
+}
+
+void SimulationEngine::ensureContractionHierarchy() {
+    if (!m_roadGraphLoaded || m_hierarchy.matches(m_roadGraph)) return;
+
+    // Prétraitement déjà fait pour ce graphe : relecture (empreinte vérifiée par load)
+    QString error;
+    if (!m_hierarchyCachePath.isEmpty() &&
+        ContractionHierarchy::load(m_hierarchyCachePath, m_roadGraph, m_hierarchy, &error)) {
+        qInfo() << "Hiérarchie de routage chargée:" << m_hierarchyCachePath;
+        return;
+    }
+
+    m_hierarchy = ContractionHierarchy::build(m_roadGraph);
+    qInfo() << "Hiérarchie de routage construite:" << m_hierarchy.shortcutCount() << "raccourcis";
+    if (!m_hierarchyCachePath.isEmpty() && !m_hierarchy.save(m_hierarchyCachePath, &error)) {
+        qWarning() << "Hiérarchie de routage non sauvegardée:" << error;
+    }
+}
+
+TravelTimeMatrix SimulationEngine::travelTimeMatrix(const QVector<int>& sourceNodes, const QVector<int>& targetNodes) {
+    ensureContractionHierarchy();
+    return TravelTimeMatrix::compute(m_hierarchy, sourceNodes, targetNodes, m_threadPool);
+}
+
+void SimulationEngine::assignRoutes() {
+    if (!m_routingEnabled || m_hierarchy.isEmpty()) return;
+
+    // Passe séquentielle (ordre des indices) : les tirages de destination et les
+    // requêtes ne dépendent pas du nombre de threads
+    const auto& edges = m_roadGraph.edges();
+    const int nodeCount = m_roadGraph.nodes().size();
+    for (int i = 0; i < m_vehicles.size(); ++i) {
+        VehicleState& state = m_vehicles.state(i);
+        if (state.routeCursor < state.route.size() || m_simulationTimeMs < state.nextRouteAttemptMs) {
+            continue;
+        }
+
+        // L'itinéraire part du nœud vers lequel le véhicule roule
+        const RoadEdge& edge = edges.at(m_vehicles.edgeIndices().at(i));
+        const int startNode = m_vehicles.isMovingForward(i) ? edge.toNode : edge.fromNode;
+
+        bool assigned = false;
+        for (int attempt = 0; attempt < ROUTE_DESTINATION_ATTEMPTS && !assigned; ++attempt) {
+            const int destination = state.rng.bounded(nodeCount);
+            if (destination == startNode) continue;
+            assigned = m_routeQuery.route(m_hierarchy, startNode, destination, state.route) &&
+                       !state.route.isEmpty();
+            if (assigned) {
+                state.destinationNode = destination;
+            }
+        }
+        state.routeCursor = 0;
+        if (assigned) {
+            ++m_routeAssignmentCount;
+        } else {
+            // Nœud isolé ou composante sans issue : marche aléatoire, nouvel essai plus tard
+            state.route.clear();
+            state.destinationNode = -1;
+            state.nextRouteAttemptMs = m_simulationTimeMs + ROUTE_RETRY_INTERVAL_MS;
+        }
+    }
+}
+
+int SimulationEngine::selectNextEdge(int currentNodeIndex, int currentEdgeIndex, bool movingForward,
+                                     RandomStream& rng) {
+    Q_UNUSED(movingForward);
+    const auto& nodes = m_roadGraph.nodes();
+    if (currentNodeIndex < 0 || currentNodeIndex >= nodes.size()) return -1;
+
+    const auto& edges = m_roadGraph.edges();
+
+    // Candidats : arêtes sortantes du nœud, plus les arêtes entrantes
+    // bidirectionnelles (parcourues en sens inverse). Coût en O(degré).
+    QVarLengthArray<int, 16> candidateEdges;
+    for (int edgeIdx : m_roadGraph.outgoingEdges(currentNodeIndex)) {
+        if (edgeIdx != currentEdgeIndex) {
+            candidateEdges.append(edgeIdx);
+        }
+    }
+    for (int edgeIdx : m_roadGraph.incomingEdges(currentNodeIndex)) {
+        const RoadEdge& edge = edges.at(edgeIdx);
+        // Les boucles (fromNode == toNode) sont déjà comptées comme sortantes
+        if (edgeIdx != currentEdgeIndex && !m_roadGraph.edgeAttributes(edgeIdx).oneway &&
+            edge.fromNode != currentNodeIndex) {
+            candidateEdges.append(edgeIdx);
+        }
+    }
+
+    if (candidateEdges.isEmpty()) return -1;
+
+    // Sélectionner aléatoirement une arête candidate (flux du véhicule)
+    return candidateEdges.at(rng.bounded(static_cast<int>(candidateEdges.size())));
+}
+
+double SimulationEngine::calculateDistance(double lat1, double lon1, double lat2, double lon2) {
+    return Proximity::haversineMeters(lat1, lon1, lat2, lon2);
+}
+
+// ========== Système de messages V2V ==========
+
+V2VMessage SimulationEngine::createMessage(V2VMessageType type, int vehicleIndex, int ttl) {
+    // Les messages portent des coordonnées géographiques : conversion depuis le repère local
+    double lat = 0.0;
+    double lon = 0.0;
+    m_roadGraph.localFrame().toLatLon(m_vehicles.positionsX().at(vehicleIndex),
+                                      m_vehicles.positionsY().at(vehicleIndex), lat, lon);
+    VehicleState& sender = m_vehicles.state(vehicleIndex);
+    return V2VMessage(type,
+                      sender.id,
+                      lat,
+                      lon,
+                      m_vehicles.speedKmh(vehicleIndex),
+                      ttl,
+                      m_simulationTimeMs,
+                      sender.nextMessageSequence++);
+}
+
+void SimulationEngine::broadcastFrom(int senderIndex, const V2VMessage& message) {
+    // Phase d'envoi : le message est stocké une fois ; les récepteurs à portée
+    // le tireront pendant la phase de réception
+    m_messages.post(message, senderIndex);
+}
+
+void SimulationEngine::deliverMessages() {
+    m_messages.beginDelivery();
+
+    // Parcours cellule par cellule : les voisins d'un bloc de récepteurs sont
+    // proches en mémoire. Chaque récepteur n'écrit que dans sa propre boîte.
+    const QVector<int>& receivers = m_neighborLists.vehiclesByCell();
+    const int count = m_vehicles.size();
+    const bool byCell = receivers.size() == count;
+
+    m_threadPool.parallelFor(0, count, MESSAGING_BLOCK_SIZE, [this, &receivers, byCell](int begin, int end) {
+        QVarLengthArray<int, 256> incoming;
+        for (int k = begin; k < end; ++k) {
+            const int receiverIndex = byCell ? receivers.at(k) : k;
+
+            incoming.clear();
+            m_neighborLists.forEachInRange(receiverIndex, m_vehicles, [this, &incoming](int senderIndex) {
+                for (int messageIndex : m_messages.sentBy(senderIndex)) {
+                    incoming.append(messageIndex);
+                }
+            });
+
+            // Ordre de publication : boîte identique quel que soit le nombre de threads
+            std::sort(incoming.begin(), incoming.end());
+            for (int messageIndex : incoming) {
+                m_messages.deliver(receiverIndex, messageIndex);
+            }
+        }
+    });
+}
+
+QVector<QPair<int, int>> SimulationEngine::connectedVehiclePairs() const {
+    QVector<QPair<int, int>> pairs;
+    for (int i = 0; i < m_vehicles.size(); ++i) {
+        m_neighborLists.forEachInRange(i, m_vehicles, [&pairs, i](int other) {
+            if (i < other) {
+                pairs.append(qMakePair(i, other));
+            }
+        });
+    }
+    return pairs;
+}
+
+int SimulationEngine::connectionCount(int vehicleIndex) const {
+    if (vehicleIndex < 0 || vehicleIndex >= m_vehicles.size()) return 0;
+
+    int count = 0;
+    m_neighborLists.forEachInRange(vehicleIndex, m_vehicles, [&count](int) { ++count; });
+    return count;
+}
+
+void SimulationEngine::scheduleCamEvents() {
+    m_events.clear();
+    m_events.reserve(m_vehicles.size());
+
+    // Phases réparties uniformément sur la période : les émissions sont étalées
+    // sur tous les pas au lieu d'arriver en rafale au même instant
+    const int count = m_vehicles.size();
+    for (int i = 0; i < count; ++i) {
+        const qint64 interval = m_vehicles.state(i).camIntervalMs;
+        SimulationEvent event;
+        event.type = SimulationEventType::CAM;
+        event.vehicleIndex = i;
+        event.timeMs = m_simulationTimeMs + (interval * (i + 1)) / count;
+        m_events.push(event);
+    }
+}
+
+void SimulationEngine::processDueEvents() {
+    while (m_events.hasDueEvent(m_simulationTimeMs)) {
+        SimulationEvent event = m_events.pop();
+        if (event.vehicleIndex < 0 || event.vehicleIndex >= m_vehicles.size()) continue;
+
+        switch (event.type) {
+        case SimulationEventType::CAM:
+            sendCAMMessage(event.vehicleIndex);
+            // Prochaine émission du véhicule, à sa propre période
+            event.timeMs += std::max<qint64>(m_vehicles.state(event.vehicleIndex).camIntervalMs, 1);
+            m_events.push(event);
+            break;
+        }
+    }
+}
+
+void SimulationEngine::sendCAMMessage(int senderIndex) {
+    // Créer un message CAM avec position et vitesse actuelles
+    // TTL = 1 pour CAM (pas de relais)
+    V2VMessage camMessage = createMessage(V2VMessageType::CAM, senderIndex, 1);
+
+    // Envoyer à tous les véhicules à portée
+    broadcastFrom(senderIndex, camMessage);
+
+    m_vehicles.state(senderIndex).messagesSent++;
+}
+
+void SimulationEngine::processV2VMessages() {
+    // Les boîtes ne contiennent que des CAM (TTL = 1, sans relais) : les alertes
+    // sont propagées en une passe par triggerAlertForVehicle. Chaque véhicule ne
+    // modifie que son propre état.
+    m_threadPool.parallelFor(0, m_vehicles.size(), MESSAGING_BLOCK_SIZE, [this](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            m_vehicles.state(i).messagesReceived += m_messages.inbox(i).size();
+        }
+    });
+}
+
+void SimulationEngine::detectEmergencyStop() {
+    const double speedDropThreshold = 30.0; // Réduction de vitesse de 30 km/h ou plus
+
+    for (int i = 0; i < m_vehicles.size(); ++i) {
+        VehicleState& vehicle = m_vehicles.state(i);
+        double currentSpeed = m_vehicles.speedKmh(i);
+        double previousSpeed = vehicle.previousSpeedKmh;
+
+        // Initialiser la vitesse précédente si c'est la première fois
+        if (previousSpeed == 0.0 && vehicle.messagesSent == 0) {
+            vehicle.previousSpeedKmh = currentSpeed;
+            continue;
+        }
+
+        // Détecter arrêt brutal : vitesse < seuil ET réduction importante
+        if (currentSpeed < EMERGENCY_STOP_THRESHOLD &&
+            previousSpeed > EMERGENCY_STOP_THRESHOLD &&
+            (previousSpeed - currentSpeed) >= speedDropThreshold) {
+
+            // Déclencher une alerte
+            triggerAlertForVehicle(vehicle.id);
+        }
+
+        // Stocker la vitesse actuelle pour la prochaine itération
+        m_vehicles.state(i).previousSpeedKmh = currentSpeed;
+    }
+}
+
+void SimulationEngine::triggerAlertForVehicle(int vehicleId) {
+    int vehicleIndex = vehicleId - 1;
+    if (vehicleIndex < 0 || vehicleIndex >= m_vehicles.size()) return;
+
+    VehicleState& vehicle = m_vehicles.state(vehicleIndex);
+
+    // Ne pas déclencher plusieurs alertes pour le même véhicule
+    if (vehicle.hasActiveAlert) return;
+
+    vehicle.hasActiveAlert = true;
+    vehicle.alertTimestamp = m_simulationTimeMs;
+
+    // Créer un message ALERT avec TTL = 3 sauts et le propager en une passe sur
+    // le graphe de voisinage courant (au lieu d'un saut par pas via les boîtes de réception)
+    const V2VMessage alert = createMessage(V2VMessageType::ALERT, vehicleIndex, ALERT_TTL);
+    vehicle.messagesSent++;
+
+    const AlertPropagationResult& result =
+        m_alertPropagation.propagate(alert, vehicleIndex, m_neighborLists, m_vehicles);
+
+    for (const AlertReception& reception : result.receptions) {
+        VehicleState& receiver = m_vehicles.state(reception.vehicleIndex);
+        receiver.messagesReceived++;
+        receiver.hasReceivedAlert = true;
+        receiver.receivedAlertTimestamp = reception.deliveryTimeMs;
+        receiver.alertHopCount = reception.hopCount;
+    }
+    for (int relayIndex : result.relayIndices) {
+        m_vehicles.state(relayIndex).alertsRelayed++;
+    }
+}
+
+void SimulationEngine::expireReceivedAlerts() {
+    // L'état "alerte reçue" n'est affiché que pendant quelques secondes
+    for (int i = 0; i < m_vehicles.size(); ++i) {
+        VehicleState& vehicle = m_vehicles.state(i);
+        if (vehicle.hasReceivedAlert &&
+            m_simulationTimeMs - vehicle.receivedAlertTimestamp >= RECEIVED_ALERT_DURATION_MS) {
+            vehicle.hasReceivedAlert = false;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <QVector>
+#include <QPair>
+#include <QtGlobal>
+
+#include "RoadGraph.h"
+#include "Vehicle.h"
+#include "VehicleStore.h"
+#include "EdgeOccupancy.h"
+#include "V2VMessage.h"
+#include "RandomStream.h"
+#include "ThreadPool.h"
+#include "Proximity.h"
+#include "NeighborLists.h"
+#include "EventQueue.h"
+#include "MessageArena.h"
+#include "ContractionHierarchy.h"
+#include "TravelTimeMatrix.h"
+#include "AlertPropagation.h"
+
+// Instantané de l'état de la simulation, consommé par l'interface (MapView).
+// QVector étant partagé implicitement, la copie est peu coûteuse tant que le
+// moteur ne modifie pas ses véhicules.
+struct SimulationSnapshot {
+    qint64 simulationTimeMs = 0;
+    QVector<Vehicle> vehicles;
+    AlertPropagationResult lastAlert; // Dernière alerte propagée (liens émetteur -> récepteur)
+};
+
+// Moteur de simulation sans dépendance à QtWidgets : possède le graphe routier
+// et les véhicules, et avance par pas de temps fixe (temps simulé).
+class SimulationEngine {
+public:
+    static constexpr double DEFAULT_TIME_STEP_SECONDS = 0.016; // ~60 Hz
+    static constexpr qint64 CAM_INTERVAL_MS = 500; // Intervalle moyen entre messages CAM (500ms)
+    static constexpr qint64 CAM_INTERVAL_SPREAD_MS = 100; // Période CAM d'un véhicule : CAM_INTERVAL_MS ± cet écart
+    static constexpr double EMERGENCY_STOP_THRESHOLD = 5.0; // Seuil de vitesse pour arrêt brutal (km/h)
+    static constexpr qint64 RECEIVED_ALERT_DURATION_MS = 3000; // Durée d'affichage d'une alerte reçue
+    static constexpr quint64 DEFAULT_SEED = 42;
+    static constexpr int ALERT_TTL = 3; // Relais autorisés pour une alerte (portée max : ALERT_TTL + 1 sauts)
+    static constexpr int MOVEMENT_BLOCK_SIZE = 256; // Véhicules par bloc de la phase de déplacement
+    static constexpr int MESSAGING_BLOCK_SIZE = 256; // Véhicules par bloc des phases de réception/traitement
+    static constexpr int ROUTE_DESTINATION_ATTEMPTS = 4; // Destinations tirées par véhicule et par tentative
+    static constexpr qint64 ROUTE_RETRY_INTERVAL_MS = 1000; // Délai avant nouvelle tentative après un échec
+
+    // hierarchyCachePath : fichier de la hiérarchie de routage de ce graphe, relu
+    // s'il correspond au graphe et écrit après chaque construction (vide : aucun)
+    void setRoadGraph(RoadGraph graph, const QString& hierarchyCachePath = QString());
+    const RoadGraph& roadGraph() const { return m_roadGraph; }
+    bool hasRoadGraph() const { return m_roadGraphLoaded; }
+
+    // Graine unique du scénario : génération des véhicules et flux par véhicule.
+    // Prise en compte au prochain generateVehicles().
+    void setSeed(quint64 seed) { m_seed = seed; }
+    quint64 seed() const { return m_seed; }
+
+    void generateVehicles(int count);
+    const VehicleStore& vehicles() const { return m_vehicles; }
+    // Files de véhicules par arête et sens (meneur/suiveur, densité), à jour au dernier pas
+    const EdgeOccupancy& edgeOccupancy() const { return m_edgeOccupancy; }
+    SimulationSnapshot snapshot() const;
+
+    // Pas de temps fixe utilisé par runFor()
+    void setFixedTimeStep(double seconds);
+    double fixedTimeStep() const { return m_fixedTimeStep; }
+
+    // Avance la simulation d'un pas de dt secondes (temps simulé)
+    void step(double deltaTimeSeconds);
+    // Avance de simSeconds par pas fixes ; le reliquat est conservé pour l'appel suivant.
+    // Retourne le nombre de pas effectués.
+    int runFor(double simSeconds);
+
+    // Nombre de threads des phases de déplacement et de messagerie (<= 0 : un par cœur).
+    // Le résultat de la simulation ne dépend pas de ce réglage.
+    void setWorkerCount(int count) { m_threadPool.setThreadCount(count); }
+    int workerCount() const { return m_threadPool.threadCount(); }
+
+    // Marge (m) des listes de voisins : une liste est reconstruite quand son
+    // véhicule s'est déplacé de plus de skin / 2. Prise en compte au prochain generateVehicles().
+    void setNeighborSkin(double meters) { m_neighborLists.setSkin(meters); }
+    double neighborSkin() const { return m_neighborLists.skin(); }
+    qint64 neighborListRebuildCount() const { return m_neighborLists.rebuildCount(); }
+    int lastStepNeighborListRebuildCount() const { return m_neighborLists.lastUpdateRebuildCount(); }
+
+    // Capacité de la boîte de réception de chaque véhicule (messages par pas).
+    // Prise en compte au prochain generateVehicles().
+    void setInboxCapacity(int capacity) { m_inboxCapacity = qMax(capacity, 1); }
+    int inboxCapacity() const { return m_inboxCapacity; }
+    qint64 droppedCamCount() const { return m_messages.droppedCamCount(); }
+
+    // Itinéraires origine/destination, calculés sur une hiérarchie de contraction, à
+    // la place de la marche aléatoire aux intersections : un itinéraire est attribué
+    // à chaque véhicule à sa création puis à chaque arrivée. À l'activation, sans
+    // hiérarchie valide pour le graphe, elle est relue depuis le fichier de
+    // setRoadGraph() ou, à défaut, construite puis sauvegardée.
+    void setRoutingEnabled(bool enabled);
+    bool isRoutingEnabled() const { return m_routingEnabled; }
+    // Hiérarchie préparée à l'avance (ContractionHierarchy::load) ou à sauvegarder
+    void setContractionHierarchy(ContractionHierarchy hierarchy) { m_hierarchy = std::move(hierarchy); }
+    const ContractionHierarchy& contractionHierarchy() const { return m_hierarchy; }
+    qint64 routeAssignmentCount() const { return m_routeAssignmentCount; }
+    // Temps de parcours (s) entre des ensembles de nœuds du graphe, calculés en lot
+    // sur la hiérarchie de routage (construite au besoin) et répartis sur le pool
+    TravelTimeMatrix travelTimeMatrix(const QVector<int>& sourceNodes, const QVector<int>& targetNodes);
+
+    qint64 simulationTimeMs() const { return m_simulationTimeMs; }
+    double simulationTimeSeconds() const { return m_simulationTimeMs / 1000.0; }
+
+    // Déclenche une alerte et la propage immédiatement sur plusieurs sauts
+    void triggerAlertForVehicle(int vehicleId);
+    // Latence simulée d'un saut : l'heure de réception vaut déclenchement + sauts * latence
+    void setAlertHopLatencyMs(qint64 latencyMs) { m_alertPropagation.setHopLatencyMs(latencyMs); }
+    qint64 alertHopLatencyMs() const { return m_alertPropagation.hopLatencyMs(); }
+    // Bilan (récepteurs, sauts, relais) de la dernière alerte déclenchée
+    const AlertPropagationResult& lastAlertPropagation() const { return m_alertPropagation.lastResult(); }
+
+    // Requêtes de portée (listes de voisins à jour au dernier pas), par indice de véhicule
+    QVector<QPair<int, int>> connectedVehiclePairs() const; // Paires (i < j) à portée radio
+    int connectionCount(int vehicleIndex) const;
+
+    static double calculateDistance(double lat1, double lon1, double lat2, double lon2);
+
+private:
+    RoadGraph m_roadGraph;
+    bool m_roadGraphLoaded = false;
+    VehicleStore m_vehicles;
+    EdgeOccupancy m_edgeOccupancy;
+    NeighborLists m_neighborLists;
+    MessageArena m_messages;
+    AlertPropagation m_alertPropagation;
+    quint64 m_seed = DEFAULT_SEED;
+    int m_inboxCapacity = MessageArena::DEFAULT_INBOX_CAPACITY;
+
+    double m_fixedTimeStep = DEFAULT_TIME_STEP_SECONDS;
+    double m_timeAccumulator = 0.0;
+    double m_simulationTimeSeconds = 0.0;
+    qint64 m_simulationTimeMs = 0;
+    EventQueue m_events; // Émissions CAM planifiées, chaque véhicule avec sa propre phase
+
+    ThreadPool m_threadPool;
+
+    // Routage
+    bool m_routingEnabled = false;
+    ContractionHierarchy m_hierarchy;
+    QString m_hierarchyCachePath;
+    RouteQuery m_routeQuery;
+    qint64 m_routeAssignmentCount = 0;
+
+    // Déplacement
+    void updateVehiclePositions(double deltaTimeSeconds);
+    void updateVehicleOnEdge(int vehicleIndex);
+    int selectNextEdge(int currentNodeIndex, int currentEdgeIndex, bool movingForward, RandomStream& rng);
+    void assignRoutes();
+    void ensureContractionHierarchy();
+
+    // Système de messages V2V
+    void scheduleCamEvents();
+    void processDueEvents();
+    void sendCAMMessage(int senderIndex);
+    void deliverMessages();
+    void processV2VMessages();
+    void detectEmergencyStop();
+    void expireReceivedAlerts();
+    V2VMessage createMessage(V2VMessageType type, int vehicleIndex, int ttl);
+    void broadcastFrom(int senderIndex, const V2VMessage& message);
+};
@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount) {
+    setThreadCount(threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+    stopWorkers();
+}
+
+void ThreadPool::setThreadCount(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) threadCount = 1;
+    }
+    if (threadCount == this->threadCount() && m_queues) return;
+
+    stopWorkers();
+    m_queues.reset(new BlockQueue[threadCount]);
+    startWorkers(threadCount - 1);
+}
+
+void ThreadPool::startWorkers(int workerCount) {
+    m_stopping = false;
+    m_workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void ThreadPool::run(int blockCount, const std::function<void(int)>& job) {
+    const int queueCount = threadCount();
+
+    // Exécution directe : un seul thread ou un seul bloc
+    if (queueCount == 1 || blockCount == 1) {
+        for (int block = 0; block < blockCount; ++block) {
+            job(block);
+        }
+        return;
+    }
+
+    // Répartition initiale en parts contiguës, une par thread
+    for (int q = 0; q < queueCount; ++q) {
+        m_queues[q].next.store(static_cast<int>(static_cast<qint64>(blockCount) * q / queueCount),
+                               std::memory_order_relaxed);
+        m_queues[q].end = static_cast<int>(static_cast<qint64>(blockCount) * (q + 1) / queueCount);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        ++m_generation;
+    }
+    m_wakeCondition.notify_all();
+
+    processBlocks(0);
+
+    // Tous les blocs sont pris : attendre ceux encore en cours chez les autres threads
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_activeWorkers == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::workerLoop(int workerIndex) {
+    quint64 seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wakeCondition.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+        if (m_stopping) return;
+
+        seenGeneration = m_generation;
+        if (!m_job) continue; // Réveil tardif : le travail est déjà terminé
+        ++m_activeWorkers;
+        lock.unlock();
+
+        processBlocks(workerIndex);
+
+        lock.lock();
+        if (--m_activeWorkers == 0) {
+            m_doneCondition.notify_all();
+        }
+    }
+}
+
+void ThreadPool::processBlocks(int queueIndex) {
+    const int queueCount = threadCount();
+    const std::function<void(int)>& job = *m_job;
+
+    // Sa propre file d'abord, puis vol dans celles des autres threads
+    for (int offset = 0; offset < queueCount; ++offset) {
+        BlockQueue& queue = m_queues[(queueIndex + offset) % queueCount];
+        for (;;) {
+            const int block = queue.next.fetch_add(1, std::memory_order_relaxed);
+            if (block >= queue.end) break;
+            job(block);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtGlobal>
+
+// Pool de threads persistants pour les phases parallèles de la simulation.
+// parallelFor() découpe une plage d'indices en blocs de taille fixe ; chaque
+// thread traite d'abord sa part contiguë de blocs puis vole les blocs restants
+// des autres threads. Le découpage ne dépend que de la taille de bloc, pas du
+// nombre de threads : un corps qui n'écrit que dans les indices de son bloc
+// produit un résultat identique quel que soit le nombre de threads.
+class ThreadPool {
+public:
+    // threadCount <= 0 : un thread par cœur disponible
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Nombre total de threads de calcul, thread appelant compris
+    int threadCount() const { return static_cast<int>(m_workers.size()) + 1; }
+    void setThreadCount(int threadCount);
+
+    // Appelle body(blockBegin, blockEnd) pour chaque bloc de [begin, end) et
+    // retourne quand tous les blocs sont traités. Le thread appelant participe.
+    template <typename Body>
+    void parallelFor(int begin, int end, int blockSize, Body&& body) {
+        if (end <= begin) return;
+        if (blockSize < 1) blockSize = 1;
+        const int blockCount = (end - begin + blockSize - 1) / blockSize;
+        run(blockCount, [&](int block) {
+            const int blockBegin = begin + block * blockSize;
+            const int blockEnd = blockBegin + blockSize < end ? blockBegin + blockSize : end;
+            body(blockBegin, blockEnd);
+        });
+    }
+
+private:
+    // File de blocs d'un thread : [next, end), consommée par l'avant par son
+    // propriétaire comme par les voleurs. Alignée pour éviter le faux partage.
+    struct alignas(64) BlockQueue {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    void run(int blockCount, const std::function<void(int)>& job);
+    void workerLoop(int workerIndex);
+    void processBlocks(int queueIndex);
+    void startWorkers(int workerCount);
+    void stopWorkers();
+
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<BlockQueue[]> m_queues;     // Une file par thread (indice 0 = appelant)
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+    const std::function<void(int)>* m_job = nullptr;
+    quint64 m_generation = 0;                   // Incrémenté à chaque parallelFor()
+    int m_activeWorkers = 0;
+    bool m_stopping = false;
+};
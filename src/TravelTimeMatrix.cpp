@@ -0,0 +1,79 @@
+#include "TravelTimeMatrix.h"
+
+#include "ContractionHierarchy.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+TravelTimeMatrix TravelTimeMatrix::compute(const ContractionHierarchy& hierarchy, const QVector<int>& sourceNodes,
+                                           const QVector<int>& targetNodes, ThreadPool& pool) {
+    TravelTimeMatrix matrix;
+    matrix.m_sourceCount = sourceNodes.size();
+    matrix.m_targetCount = targetNodes.size();
+    matrix.m_seconds.fill(UNREACHABLE, matrix.m_sourceCount * matrix.m_targetCount);
+    if (hierarchy.isEmpty() || sourceNodes.isEmpty() || targetNodes.isEmpty()) return matrix;
+
+    const int nodeCount = hierarchy.nodeCount();
+    const int targetCount = matrix.m_targetCount;
+
+    // 1. Recherches arrière depuis les cibles, un tampon d'entrées par bloc
+    struct BucketEntry {
+        int node;
+        int targetIndex;
+        double seconds;
+    };
+    QVector<QVector<BucketEntry>> blockEntries((targetCount + SEARCH_BLOCK_SIZE - 1) / SEARCH_BLOCK_SIZE);
+    pool.parallelFor(0, targetCount, SEARCH_BLOCK_SIZE, [&](int begin, int end) {
+        RouteQuery query;
+        QVector<SettledNode> settled;
+        QVector<BucketEntry>& entries = blockEntries[begin / SEARCH_BLOCK_SIZE];
+        for (int t = begin; t < end; ++t) {
+            query.upwardSearch(hierarchy, targetNodes.at(t), false, settled);
+            for (const SettledNode& reached : std::as_const(settled)) {
+                entries.append({reached.node, t, reached.seconds});
+            }
+        }
+    });
+
+    // 2. Seaux par nœud en CSR (tri par comptage, cibles dans l'ordre au sein d'un seau)
+    QVector<int> bucketOffsets(nodeCount + 1, 0);
+    for (const QVector<BucketEntry>& entries : std::as_const(blockEntries)) {
+        for (const BucketEntry& entry : entries) {
+            ++bucketOffsets[entry.node + 1];
+        }
+    }
+    for (int n = 0; n < nodeCount; ++n) {
+        bucketOffsets[n + 1] += bucketOffsets[n];
+    }
+    QVector<int> bucketTargets(bucketOffsets[nodeCount]);
+    QVector<double> bucketSeconds(bucketOffsets[nodeCount]);
+    QVector<int> cursor(bucketOffsets.constBegin(), bucketOffsets.constEnd() - 1);
+    for (const QVector<BucketEntry>& entries : std::as_const(blockEntries)) {
+        for (const BucketEntry& entry : entries) {
+            const int slot = cursor[entry.node]++;
+            bucketTargets[slot] = entry.targetIndex;
+            bucketSeconds[slot] = entry.seconds;
+        }
+    }
+    blockEntries.clear();
+
+    // 3. Recherches avant depuis les sources : chaque ligne n'est écrite que par
+    // le bloc de sa source
+    double* values = matrix.m_seconds.data();
+    pool.parallelFor(0, matrix.m_sourceCount, SEARCH_BLOCK_SIZE, [&](int begin, int end) {
+        RouteQuery query;
+        QVector<SettledNode> settled;
+        for (int s = begin; s < end; ++s) {
+            double* row = values + static_cast<qsizetype>(s) * targetCount;
+            query.upwardSearch(hierarchy, sourceNodes.at(s), true, settled);
+            for (const SettledNode& reached : std::as_const(settled)) {
+                for (int k = bucketOffsets.at(reached.node); k < bucketOffsets.at(reached.node + 1); ++k) {
+                    double& cell = row[bucketTargets.at(k)];
+                    cell = std::min(cell, reached.seconds + bucketSeconds.at(k));
+                }
+            }
+        }
+    });
+
+    return matrix;
+}
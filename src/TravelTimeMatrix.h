@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <limits>
+
+class ContractionHierarchy;
+class ThreadPool;
+
+// Matrice dense des temps de parcours (s) entre des nœuds sources et cibles du
+// graphe routier, rangée par ligne (une ligne par source).
+// Calcul « à seaux » sur la hiérarchie de contraction : une recherche montante
+// arrière par cible dépose (cible, distance) dans un seau à chaque nœud atteint,
+// puis une recherche montante avant par source combine ses distances avec les
+// seaux rencontrés. Coût ~ (S + T) recherches au lieu de S × T itinéraires.
+class TravelTimeMatrix {
+public:
+    static constexpr double UNREACHABLE = std::numeric_limits<double>::infinity();
+    static constexpr int SEARCH_BLOCK_SIZE = 32; // Recherches par bloc parallèle
+
+    // Plusieurs-à-plusieurs ; les recherches sont réparties sur le pool (résultat
+    // indépendant du nombre de threads)
+    static TravelTimeMatrix compute(const ContractionHierarchy& hierarchy, const QVector<int>& sourceNodes,
+                                    const QVector<int>& targetNodes, ThreadPool& pool);
+    // Un-à-plusieurs : matrice d'une seule ligne
+    static TravelTimeMatrix compute(const ContractionHierarchy& hierarchy, int sourceNode,
+                                    const QVector<int>& targetNodes, ThreadPool& pool) {
+        return compute(hierarchy, QVector<int>{sourceNode}, targetNodes, pool);
+    }
+
+    int sourceCount() const { return m_sourceCount; }
+    int targetCount() const { return m_targetCount; }
+    double seconds(int sourceIndex, int targetIndex) const {
+        return m_seconds.at(sourceIndex * m_targetCount + targetIndex);
+    }
+    bool isReachable(int sourceIndex, int targetIndex) const {
+        return seconds(sourceIndex, targetIndex) != UNREACHABLE;
+    }
+    const QVector<double>& values() const { return m_seconds; }
+
+private:
+    int m_sourceCount = 0;
+    int m_targetCount = 0;
+    QVector<double> m_seconds;
+};
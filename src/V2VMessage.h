@@ -15,25 +15,36 @@ struct V2VMessage {
     double latitude = 0.0;
     double longitude = 0.0;
     double speedKmh = 0.0;
-    qint64 timestamp = 0;  // Timestamp en millisecondes
+    qint64 timestamp = 0;  // Timestamp en millisecondes (temps simulé)
     int ttl = 1;          // Time To Live (nombre de sauts restants)
-    QString messageId;    // Identifiant unique pour éviter les boucles
+    quint64 messageId = 0; // Identifiant unique pour éviter les boucles (voir makeMessageId)
     
     V2VMessage() = default;
     
-    V2VMessage(V2VMessageType msgType, int id, double lat, double lon, double speed, int hops = 1)
+    // sequence : numéro d'ordre du message chez son émetteur
+    V2VMessage(V2VMessageType msgType, int id, double lat, double lon, double speed, int hops = 1,
+               qint64 timestampMs = QDateTime::currentMSecsSinceEpoch(), quint32 sequence = 0)
         : type(msgType)
         , senderId(id)
         , latitude(lat)
         , longitude(lon)
         , speedKmh(speed)
-        , timestamp(QDateTime::currentMSecsSinceEpoch())
+        , timestamp(timestampMs)
         , ttl(hops)
+        , messageId(makeMessageId(id, sequence, msgType))
     {
-        // Générer un ID unique pour le message
-        messageId = QString("%1_%2_%3").arg(senderId).arg(timestamp).arg(static_cast<int>(type));
     }
     
+    // Identifiant compacté sur 64 bits : émetteur (24 bits) | séquence (32 bits) | type (8 bits)
+    static quint64 makeMessageId(int senderId, quint32 sequence, V2VMessageType type) {
+        return (static_cast<quint64>(senderId & 0xFFFFFF) << 40)
+             | (static_cast<quint64>(sequence) << 8)
+             | static_cast<quint64>(static_cast<quint8>(type));
+    }
+    static int senderOf(quint64 messageId) { return static_cast<int>(messageId >> 40); }
+    static quint32 sequenceOf(quint64 messageId) { return static_cast<quint32>(messageId >> 8); }
+    static V2VMessageType typeOf(quint64 messageId) { return static_cast<V2VMessageType>(messageId & 0xFF); }
+    
     bool isValid() const {
         return senderId > 0 && ttl > 0;
     }
@@ -0,0 +1,120 @@
+#include "VehicleStore.h"
+
+#include "RoadGraph.h"
+
+#include <algorithm>
+
+void VehicleStore::clear() {
+    m_edgeIndex.clear();
+    m_positionOnEdge.clear();
+    m_direction.clear();
+    m_speedMs.clear();
+    m_progressRate.clear();
+    m_x.clear();
+    m_y.clear();
+    m_transmissionRadius.clear();
+    m_states.clear();
+}
+
+void VehicleStore::reserve(int count) {
+    m_edgeIndex.reserve(count);
+    m_positionOnEdge.reserve(count);
+    m_direction.reserve(count);
+    m_speedMs.reserve(count);
+    m_progressRate.reserve(count);
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_transmissionRadius.reserve(count);
+    m_states.reserve(count);
+}
+
+int VehicleStore::append(const Vehicle& vehicle, const EdgeGeometry& edges) {
+    if (vehicle.edgeIndex() < 0 || vehicle.edgeIndex() >= edges.inverseLength.size()) {
+        return -1;
+    }
+
+    int index = size();
+    m_edgeIndex.append(-1);
+    m_positionOnEdge.append(0.0);
+    m_direction.append(1.0);
+    m_speedMs.append(0.0);
+    m_progressRate.append(0.0);
+    m_x.append(0.0);
+    m_y.append(0.0);
+    m_transmissionRadius.append(vehicle.transmissionRadiusMeters());
+    m_states.append(vehicle.state());
+
+    placeOnEdge(index, vehicle.edgeIndex(), vehicle.positionOnEdge(), vehicle.isMovingForward(),
+                vehicle.speedKmh(), edges);
+    interpolatePositions(edges, index, index + 1);
+    return index;
+}
+
+Vehicle VehicleStore::vehicle(int index, const LocalFrame& frame) const {
+    double lat = 0.0;
+    double lon = 0.0;
+    frame.toLatLon(m_x.at(index), m_y.at(index), lat, lon);
+
+    Vehicle vehicle;
+    vehicle.setState(m_states.at(index));
+    vehicle.setLatLon(lat, lon);
+    vehicle.setSpeedKmh(speedKmh(index));
+    vehicle.setTransmissionRadiusMeters(m_transmissionRadius.at(index));
+    vehicle.setEdgeIndex(m_edgeIndex.at(index));
+    vehicle.setPositionOnEdge(m_positionOnEdge.at(index));
+    vehicle.setMovingForward(isMovingForward(index));
+    return vehicle;
+}
+
+QVector<Vehicle> VehicleStore::toVehicles(const LocalFrame& frame) const {
+    QVector<Vehicle> vehicles;
+    vehicles.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        vehicles.append(vehicle(i, frame));
+    }
+    return vehicles;
+}
+
+void VehicleStore::placeOnEdge(int index, int edgeIndex, double positionOnEdge, bool movingForward,
+                               double speedKmh, const EdgeGeometry& edges) {
+    double direction = movingForward ? 1.0 : -1.0;
+    double speedMs = speedKmh / 3.6; // Conversion km/h -> m/s
+    m_edgeIndex[index] = edgeIndex;
+    m_positionOnEdge[index] = std::clamp(positionOnEdge, 0.0, 1.0);
+    m_direction[index] = direction;
+    m_speedMs[index] = speedMs;
+    m_progressRate[index] = direction * speedMs * edges.inverseLength.at(edgeIndex);
+}
+
+void VehicleStore::advancePositions(double deltaTimeSeconds, int begin, int end) {
+    double* position = m_positionOnEdge.data();
+    const double* rate = m_progressRate.constData();
+    // La position n'est pas bornée ici : le dépassement de l'extrémité est
+    // reporté sur l'arête suivante lors de la transition.
+    for (int i = begin; i < end; ++i) {
+        position[i] += rate[i] * deltaTimeSeconds;
+    }
+}
+
+void VehicleStore::interpolatePositions(const EdgeGeometry& edges, int begin, int end) {
+    const int* edge = m_edgeIndex.constData();
+    const double* position = m_positionOnEdge.constData();
+    const double* fromX = edges.fromX.constData();
+    const double* fromY = edges.fromY.constData();
+    const double* deltaX = edges.deltaX.constData();
+    const double* deltaY = edges.deltaY.constData();
+    const int* shapeOffset = edges.shapeOffset.constData();
+    double* x = m_x.data();
+    double* y = m_y.data();
+
+    for (int i = begin; i < end; ++i) {
+        const int e = edge[i];
+        const double t = std::min(std::max(position[i], 0.0), 1.0);
+        if (shapeOffset[e] == shapeOffset[e + 1]) {
+            x[i] = fromX[e] + deltaX[e] * t;
+            y[i] = fromY[e] + deltaY[e] * t;
+        } else {
+            edges.pointOnShape(e, t, x[i], y[i]);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include "Vehicle.h"
+
+struct EdgeGeometry;
+struct LocalFrame;
+
+// Stockage des véhicules en structure de tableaux (SoA).
+// Les champs chauds (lus et écrits à chaque pas) sont contigus, un tableau par
+// champ ; l'état froid (compteurs, alertes, messagerie) est rangé à part.
+// Les positions sont exprimées dans le repère métrique local du graphe et ne
+// sont converties en latitude/longitude que pour l'affichage et l'export.
+// L'indice d'un véhicule dans le store vaut id - 1.
+class VehicleStore {
+public:
+    int size() const { return m_edgeIndex.size(); }
+    bool isEmpty() const { return m_edgeIndex.isEmpty(); }
+    void clear();
+    void reserve(int count);
+
+    // Ajoute un véhicule (éclaté en champs chauds / état froid) et retourne son indice
+    int append(const Vehicle& vehicle, const EdgeGeometry& edges);
+    // Reconstitue la vue objet d'un véhicule (instantanés, affichage)
+    Vehicle vehicle(int index, const LocalFrame& frame) const;
+    QVector<Vehicle> toVehicles(const LocalFrame& frame) const;
+
+    // Place le véhicule sur une arête et recalcule sa vitesse de progression
+    void placeOnEdge(int index, int edgeIndex, double positionOnEdge, bool movingForward,
+                     double speedKmh, const EdgeGeometry& edges);
+
+    // Noyaux de mise à jour sur la plage [begin, end), sans accès aux données
+    // froides. advancePositions est sans branchement (vectorisable) ;
+    // interpolatePositions ne cherche le segment que sur les arêtes en polyligne.
+    void advancePositions(double deltaTimeSeconds, int begin, int end);
+    void interpolatePositions(const EdgeGeometry& edges, int begin, int end);
+
+    // Le véhicule a-t-il atteint l'extrémité de son arête dans son sens de marche ?
+    bool hasReachedEdgeEnd(int index) const {
+        double position = m_positionOnEdge.at(index);
+        return m_direction.at(index) > 0.0 ? position >= 1.0 : position <= 0.0;
+    }
+
+    // Champs chauds
+    const QVector<int>& edgeIndices() const { return m_edgeIndex; }
+    const QVector<double>& positionsOnEdge() const { return m_positionOnEdge; }
+    const QVector<double>& directions() const { return m_direction; }
+    const QVector<double>& speedsMs() const { return m_speedMs; }
+    const QVector<double>& positionsX() const { return m_x; }
+    const QVector<double>& positionsY() const { return m_y; }
+    const QVector<double>& transmissionRadii() const { return m_transmissionRadius; }
+
+    double speedKmh(int index) const { return m_speedMs.at(index) * 3.6; }
+    bool isMovingForward(int index) const { return m_direction.at(index) > 0.0; }
+
+    // État froid
+    VehicleState& state(int index) { return m_states[index]; }
+    const VehicleState& state(int index) const { return m_states.at(index); }
+
+private:
+    // Champs chauds (un tableau par champ)
+    QVector<int> m_edgeIndex;
+    QVector<double> m_positionOnEdge;   // 0.0 = fromNode, 1.0 = toNode (non borné avant transition)
+    QVector<double> m_direction;        // +1.0 vers toNode, -1.0 vers fromNode
+    QVector<double> m_speedMs;
+    QVector<double> m_progressRate;     // direction * vitesse / longueur (fraction d'arête par seconde)
+    QVector<double> m_x;                // Est (m) dans le repère local
+    QVector<double> m_y;                // Nord (m) dans le repère local
+    QVector<double> m_transmissionRadius; // Portée radio (m), lue par les tests de portée
+
+    // État froid
+    QVector<VehicleState> m_states;
+};
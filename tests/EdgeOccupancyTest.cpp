@@ -0,0 +1,186 @@
+// Ordre des files de véhicules par voie (EdgeOccupancy::update) après des
+// dépassements multiples dans une même voie, des changements de voie et des
+// demi-tours : chaque voie doit rester triée de l'arrière vers l'avant.
+
+#include "EdgeOccupancy.h"
+#include "RoadGraph.h"
+#include "VehicleStore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int EDGE_COUNT = 3;
+constexpr int RANDOM_VEHICLES = 40;
+constexpr int RANDOM_STEPS = 2000;
+
+int failures = 0;
+
+void check(bool condition, const char* what, int a, int b) {
+    if (!condition) {
+        ++failures;
+        if (failures <= 20) {
+            std::fprintf(stderr, "ÉCHEC %s : %d / %d\n", what, a, b);
+        }
+    }
+}
+
+// Chemin de EDGE_COUNT arêtes à double sens
+RoadGraph makeGraph() {
+    RoadGraph graph;
+    WayAttributes attributes;
+    attributes.wayId = 1;
+    const int attributeIndex = graph.addWayAttributes(attributes);
+    for (int i = 0; i <= EDGE_COUNT; ++i) {
+        RoadNode node;
+        node.id = i + 1;
+        node.lat = 47.75;
+        node.lon = 7.33 + i * 0.005;
+        graph.addNode(node);
+    }
+    for (int i = 0; i < EDGE_COUNT; ++i) {
+        RoadEdge edge;
+        edge.id = i + 1;
+        edge.fromNode = i;
+        edge.toNode = i + 1;
+        edge.lengthMeters = 375.0;
+        edge.attributeIndex = attributeIndex;
+        graph.addEdge(edge);
+    }
+    graph.buildAdjacency();
+    graph.buildGeometry();
+    return graph;
+}
+
+double progress(const VehicleStore& vehicles, int index) {
+    const double position = vehicles.positionsOnEdge().at(index);
+    return vehicles.isMovingForward(index) ? position : 1.0 - position;
+}
+
+// Vérifie chaque voie : ordre arrière -> avant, chaînage, longueurs, appartenance
+void checkLanes(const EdgeOccupancy& occupancy, const VehicleStore& vehicles) {
+    int seen = 0;
+    for (int edge = 0; edge < EDGE_COUNT; ++edge) {
+        for (bool forward : {true, false}) {
+            int length = 0;
+            int previous = EdgeOccupancy::NO_VEHICLE;
+            occupancy.forEachOnLane(edge, forward, [&](int index) {
+                check(vehicles.edgeIndices().at(index) == edge && vehicles.isMovingForward(index) == forward,
+                      "voie du véhicule", index, edge);
+                check(occupancy.follower(index) == previous, "suiveur", occupancy.follower(index), previous);
+                if (previous != EdgeOccupancy::NO_VEHICLE) {
+                    check(occupancy.leader(previous) == index, "meneur", occupancy.leader(previous), index);
+                    check(progress(vehicles, previous) <= progress(vehicles, index), "ordre de la voie", previous, index);
+                }
+                previous = index;
+                ++length;
+            });
+            check(occupancy.frontVehicle(edge, forward) == previous, "véhicule de tête",
+                  occupancy.frontVehicle(edge, forward), previous);
+            check(occupancy.queueLength(edge, forward) == length, "longueur de file",
+                  occupancy.queueLength(edge, forward), length);
+            seen += length;
+        }
+    }
+    check(seen == vehicles.size(), "véhicules en file", seen, vehicles.size());
+}
+
+int addVehicle(VehicleStore& vehicles, const RoadGraph& graph, int edge, double position, bool forward) {
+    Vehicle vehicle(vehicles.size() + 1, 0.0, 0.0, 50.0, 100.0);
+    vehicle.setEdgeIndex(edge);
+    vehicle.setPositionOnEdge(position);
+    vehicle.setMovingForward(forward);
+    return vehicles.append(vehicle, graph.edgeGeometry());
+}
+} // namespace
+
+int main() {
+    const RoadGraph graph = makeGraph();
+    const EdgeGeometry& edges = graph.edgeGeometry();
+
+    // 1. Deux dépassements dans la même voie pendant un pas : la file v, u, w, s
+    //    devient w (0.1), s (0.3), v (0.5), u (0.9) ; un settle() par véhicule dans
+    //    l'ordre des indices s, v, u, w la laissait en 0.1, 0.5, 0.3, 0.9.
+    {
+        VehicleStore vehicles;
+        const int s = addVehicle(vehicles, graph, 0, 0.4, true);
+        const int v = addVehicle(vehicles, graph, 0, 0.1, true);
+        const int u = addVehicle(vehicles, graph, 0, 0.2, true);
+        const int w = addVehicle(vehicles, graph, 0, 0.3, true);
+        EdgeOccupancy occupancy;
+        occupancy.build(graph, vehicles);
+        checkLanes(occupancy, vehicles);
+
+        vehicles.placeOnEdge(v, 0, 0.5, true, 50.0, edges);
+        vehicles.placeOnEdge(u, 0, 0.9, true, 50.0, edges);
+        vehicles.placeOnEdge(w, 0, 0.1, true, 50.0, edges);
+        vehicles.placeOnEdge(s, 0, 0.3, true, 50.0, edges);
+        occupancy.update(vehicles);
+        checkLanes(occupancy, vehicles);
+        check(occupancy.rearVehicle(0, true) == w, "arrière après dépassements", occupancy.rearVehicle(0, true), w);
+        check(occupancy.leader(w) == s && occupancy.leader(s) == v && occupancy.leader(v) == u,
+              "ordre après dépassements", occupancy.leader(s), v);
+    }
+
+    // 2. Pas aléatoires : avances de longueurs différentes (dépassements multiples),
+    //    changements d'arête par l'entrée et demi-tours sur place
+    int overtakingSteps = 0;
+    {
+        std::mt19937_64 rng(20240716);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        VehicleStore vehicles;
+        for (int i = 0; i < RANDOM_VEHICLES; ++i) {
+            addVehicle(vehicles, graph, static_cast<int>(rng() % EDGE_COUNT), unit(rng), rng() % 2 == 0);
+        }
+        EdgeOccupancy occupancy;
+        occupancy.build(graph, vehicles);
+        checkLanes(occupancy, vehicles);
+
+        for (int step = 0; step < RANDOM_STEPS; ++step) {
+            std::vector<double> before(RANDOM_VEHICLES);
+            for (int i = 0; i < RANDOM_VEHICLES; ++i) {
+                before[i] = progress(vehicles, i);
+            }
+            for (int i = 0; i < RANDOM_VEHICLES; ++i) {
+                const int edge = vehicles.edgeIndices().at(i);
+                const bool forward = vehicles.isMovingForward(i);
+                const double roll = unit(rng);
+                if (roll < 0.05) {
+                    // Changement d'arête : entrée par le début, petit reliquat de déplacement
+                    const int nextEdge = static_cast<int>(rng() % EDGE_COUNT);
+                    const bool nextForward = rng() % 2 == 0;
+                    const double entry = unit(rng) * 0.05;
+                    vehicles.placeOnEdge(i, nextEdge, nextForward ? entry : 1.0 - entry, nextForward, 50.0, edges);
+                } else if (roll < 0.08) {
+                    // Demi-tour sur place : même arête, sens opposé
+                    vehicles.placeOnEdge(i, edge, vehicles.positionsOnEdge().at(i), !forward, 50.0, edges);
+                } else {
+                    const double advance = unit(rng) * 0.2;
+                    const double position = vehicles.positionsOnEdge().at(i) + (forward ? advance : -advance);
+                    vehicles.placeOnEdge(i, edge, std::clamp(position, 0.0, 1.0), forward, 50.0, edges);
+                }
+            }
+            // Pas comptant au moins deux dépassements entre voisins de file
+            int overtakes = 0;
+            for (int a = 0; a < RANDOM_VEHICLES; ++a) {
+                for (int b = 0; b < RANDOM_VEHICLES; ++b) {
+                    if (a == b || occupancy.leader(a) != b) continue;
+                    if (vehicles.edgeIndices().at(a) == vehicles.edgeIndices().at(b)
+                        && vehicles.isMovingForward(a) == vehicles.isMovingForward(b)
+                        && before[a] < before[b] && progress(vehicles, a) > progress(vehicles, b)) {
+                        ++overtakes;
+                    }
+                }
+            }
+            if (overtakes >= 2) ++overtakingSteps;
+
+            occupancy.update(vehicles);
+            checkLanes(occupancy, vehicles);
+        }
+    }
+
+    std::printf("%d pas avec dépassements multiples ; %d échecs\n", overtakingSteps, failures);
+    return failures == 0 && overtakingSteps > 0 ? 0 : 1;
+}
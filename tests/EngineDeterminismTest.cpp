@@ -0,0 +1,169 @@
+// Déterminisme du moteur (SimulationEngine) : le résultat d'un scénario ne doit
+// pas dépendre du nombre de threads (setWorkerCount). Les instantanés obtenus
+// avec 1, 3 et 8 threads sont comparés bit à bit, routage désactivé puis activé.
+
+#include "ContractionHierarchy.h"
+#include "RoadGraph.h"
+#include "SimulationEngine.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace {
+constexpr int GRID_SIDE = 30;
+constexpr int VEHICLE_COUNT = 1500;
+constexpr int STEP_COUNT = 400;
+constexpr int WORKER_COUNTS[] = {1, 3, 8};
+
+int failures = 0;
+
+void check(bool condition, const char* what, long long a, long long b) {
+    if (!condition) {
+        ++failures;
+        if (failures <= 20) {
+            std::fprintf(stderr, "ÉCHEC %s : %lld / %lld\n", what, a, b);
+        }
+    }
+}
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// Grille légèrement bruitée, vitesses variées et quelques sens uniques
+RoadGraph makeGraph() {
+    std::mt19937_64 rng(20240802);
+    std::uniform_real_distribution<double> jitter(-0.0002, 0.0002);
+    RoadGraph graph;
+    for (int y = 0; y < GRID_SIDE; ++y) {
+        for (int x = 0; x < GRID_SIDE; ++x) {
+            RoadNode node;
+            node.id = y * GRID_SIDE + x + 1;
+            node.lat = 47.74 + y * 0.001 + jitter(rng);
+            node.lon = 7.32 + x * 0.0015 + jitter(rng);
+            graph.addNode(node);
+        }
+    }
+    qint64 edgeId = 1;
+    for (int y = 0; y < GRID_SIDE; ++y) {
+        for (int x = 0; x < GRID_SIDE; ++x) {
+            const int node = y * GRID_SIDE + x;
+            for (const bool horizontal : {true, false}) {
+                if (horizontal ? x + 1 >= GRID_SIDE : y + 1 >= GRID_SIDE) continue;
+                WayAttributes attributes;
+                attributes.wayId = 2 * node + (horizontal ? 0 : 1);
+                attributes.maxSpeedKmh = 30.0 + (node % 5) * 10.0;
+                attributes.oneway = horizontal && node % 7 == 0;
+                RoadEdge edge;
+                edge.id = edgeId++;
+                edge.fromNode = node;
+                edge.toNode = horizontal ? node + 1 : node + GRID_SIDE;
+                edge.lengthMeters = horizontal ? 112.0 : 111.0;
+                edge.attributeIndex = graph.addWayAttributes(attributes);
+                graph.addEdge(edge);
+            }
+        }
+    }
+    graph.buildAdjacency();
+    graph.buildGeometry();
+    return graph;
+}
+
+SimulationSnapshot run(const RoadGraph& graph, const ContractionHierarchy& hierarchy,
+                       bool routing, int workers) {
+    SimulationEngine engine;
+    engine.setWorkerCount(workers);
+    engine.setRoadGraph(graph);
+    if (routing) {
+        engine.setContractionHierarchy(hierarchy);
+        engine.setRoutingEnabled(true);
+    }
+    engine.generateVehicles(VEHICLE_COUNT);
+    for (int step = 0; step < STEP_COUNT; ++step) {
+        engine.step(SimulationEngine::DEFAULT_TIME_STEP_SECONDS);
+        if (step == 100) engine.triggerAlertForVehicle(5);
+        if (step == 300) engine.triggerAlertForVehicle(VEHICLE_COUNT / 2);
+    }
+    return engine.snapshot();
+}
+
+void compare(const SimulationSnapshot& expected, const SimulationSnapshot& actual) {
+    check(expected.simulationTimeMs == actual.simulationTimeMs, "temps simulé",
+          expected.simulationTimeMs, actual.simulationTimeMs);
+    check(expected.vehicles.size() == actual.vehicles.size(), "nombre de véhicules",
+          expected.vehicles.size(), actual.vehicles.size());
+    if (expected.vehicles.size() != actual.vehicles.size()) return;
+
+    for (int i = 0; i < expected.vehicles.size(); ++i) {
+        const Vehicle& a = expected.vehicles.at(i);
+        const Vehicle& b = actual.vehicles.at(i);
+        check(a.id() == b.id(), "identifiant", a.id(), b.id());
+        check(sameBits(a.latitude(), b.latitude()) && sameBits(a.longitude(), b.longitude()),
+              "position", a.id(), b.id());
+        check(sameBits(a.speedKmh(), b.speedKmh()), "vitesse", a.id(), b.id());
+        check(a.edgeIndex() == b.edgeIndex() && sameBits(a.positionOnEdge(), b.positionOnEdge())
+                  && a.isMovingForward() == b.isMovingForward(),
+              "position sur l'arête", a.edgeIndex(), b.edgeIndex());
+        check(a.messagesSent() == b.messagesSent(), "messages envoyés", a.messagesSent(), b.messagesSent());
+        check(a.messagesReceived() == b.messagesReceived(), "messages reçus",
+              a.messagesReceived(), b.messagesReceived());
+        check(a.alertsRelayed() == b.alertsRelayed(), "alertes relayées", a.alertsRelayed(), b.alertsRelayed());
+        check(a.hasReceivedAlert() == b.hasReceivedAlert()
+                  && a.receivedAlertTimestamp() == b.receivedAlertTimestamp()
+                  && a.alertHopCount() == b.alertHopCount(),
+              "alerte reçue", a.id(), b.id());
+        check(a.destinationNode() == b.destinationNode(), "destination",
+              a.destinationNode(), b.destinationNode());
+
+        const QVector<V2VMessage>& inboxA = a.getInbox();
+        const QVector<V2VMessage>& inboxB = b.getInbox();
+        check(inboxA.size() == inboxB.size(), "taille de la boîte de réception", inboxA.size(), inboxB.size());
+        for (int m = 0; m < qMin(inboxA.size(), inboxB.size()); ++m) {
+            check(inboxA.at(m).messageId == inboxB.at(m).messageId && inboxA.at(m).ttl == inboxB.at(m).ttl,
+                  "message reçu", a.id(), m);
+        }
+    }
+
+    const AlertPropagationResult& alertA = expected.lastAlert;
+    const AlertPropagationResult& alertB = actual.lastAlert;
+    check(alertA.receptions.size() == alertB.receptions.size(), "récepteurs de l'alerte",
+          alertA.receptions.size(), alertB.receptions.size());
+    for (int r = 0; r < qMin(alertA.receptions.size(), alertB.receptions.size()); ++r) {
+        const AlertReception& a = alertA.receptions.at(r);
+        const AlertReception& b = alertB.receptions.at(r);
+        check(a.vehicleIndex == b.vehicleIndex && a.emitterIndex == b.emitterIndex && a.hopCount == b.hopCount,
+              "réception de l'alerte", a.vehicleIndex, b.vehicleIndex);
+    }
+    check(alertA.relayIndices == alertB.relayIndices, "relais de l'alerte",
+          alertA.relayIndices.size(), alertB.relayIndices.size());
+}
+} // namespace
+
+int main() {
+    const RoadGraph graph = makeGraph();
+    const ContractionHierarchy hierarchy = ContractionHierarchy::build(graph);
+
+    for (const bool routing : {false, true}) {
+        const SimulationSnapshot reference = run(graph, hierarchy, routing, WORKER_COUNTS[0]);
+        long long received = 0;
+        for (const Vehicle& vehicle : reference.vehicles) {
+            received += vehicle.messagesReceived();
+        }
+        // Scénario non trivial : des messages ont circulé et l'alerte a été propagée
+        check(received > 0, "messages reçus (référence)", received, 0);
+        check(!reference.lastAlert.receptions.isEmpty(), "alerte propagée (référence)",
+              reference.lastAlert.receptions.size(), 0);
+
+        for (const int workers : WORKER_COUNTS) {
+            if (workers == WORKER_COUNTS[0]) continue;
+            const int before = failures;
+            compare(reference, run(graph, hierarchy, routing, workers));
+            std::printf("routage %s, %d threads : %s\n", routing ? "activé" : "désactivé", workers,
+                        failures == before ? "identique" : "DIFFÉRENT");
+        }
+    }
+
+    std::printf("%d échecs\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Précision du test de portée (repère métrique local, Proximity::inRangeMask)
+// comparée à la distance orthodromique (Proximity::haversineMeters).
+
+#include "Proximity.h"
+#include "RoadGraph.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr double CENTER_LAT = 47.750839;
+constexpr double CENTER_LON = 7.335888;
+constexpr double CITY_HALF_EXTENT_DEG = 0.05;    // Environ ±5,5 km autour du centre
+constexpr double MAX_PAIR_DISTANCE_METERS = 1000.0;
+constexpr double MAX_RELATIVE_ERROR = 1e-3;      // Écart documenté dans Proximity.h
+constexpr double THRESHOLD_MARGIN = 2e-3;        // Paires placées à ±0,2 % de la portée
+
+int failures = 0;
+
+void check(bool condition, const char* what, double a, double b) {
+    if (!condition) {
+        ++failures;
+        if (failures <= 20) {
+            std::fprintf(stderr, "ÉCHEC %s : %.6f / %.6f\n", what, a, b);
+        }
+    }
+}
+
+struct Point {
+    double lat;
+    double lon;
+};
+
+// Point à distance meters de origin dans la direction bearing (sphère, formule directe)
+Point destination(const Point& origin, double bearingRad, double meters) {
+    static constexpr double earthRadiusMeters = 6371000.0;
+    const double angular = meters / earthRadiusMeters;
+    const double lat1 = origin.lat * M_PI / 180.0;
+    const double lon1 = origin.lon * M_PI / 180.0;
+    const double lat2 = std::asin(std::sin(lat1) * std::cos(angular)
+                                  + std::cos(lat1) * std::sin(angular) * std::cos(bearingRad));
+    const double lon2 = lon1 + std::atan2(std::sin(bearingRad) * std::sin(angular) * std::cos(lat1),
+                                          std::cos(angular) - std::sin(lat1) * std::sin(lat2));
+    return Point{lat2 * 180.0 / M_PI, lon2 * 180.0 / M_PI};
+}
+} // namespace
+
+int main() {
+    const LocalFrame frame = LocalFrame::centeredOn(CENTER_LAT, CENTER_LON);
+    std::mt19937_64 rng(20240611);
+    std::uniform_real_distribution<double> offset(-CITY_HALF_EXTENT_DEG, CITY_HALF_EXTENT_DEG);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // 1. Distances dans le repère local contre haversine, paires de moins d'un kilomètre
+    double maxRelativeError = 0.0;
+    for (int pair = 0; pair < 100000; ++pair) {
+        const Point a{CENTER_LAT + offset(rng), CENTER_LON + offset(rng)};
+        const Point b = destination(a, unit(rng) * 2.0 * M_PI, 1.0 + unit(rng) * (MAX_PAIR_DISTANCE_METERS - 1.0));
+        double ax, ay, bx, by;
+        frame.toLocal(a.lat, a.lon, ax, ay);
+        frame.toLocal(b.lat, b.lon, bx, by);
+        const double local = std::hypot(bx - ax, by - ay);
+        const double reference = Proximity::haversineMeters(a.lat, a.lon, b.lat, b.lon);
+        const double relativeError = std::abs(local - reference) / reference;
+        maxRelativeError = std::max(maxRelativeError, relativeError);
+        check(relativeError <= MAX_RELATIVE_ERROR, "distance locale", local, reference);
+    }
+
+    // 2. Masque de portée contre haversine : blocs de récepteurs aléatoires et
+    //    récepteurs placés juste à l'intérieur ou à l'extérieur de la portée
+    int maskedPairs = 0;
+    int nearThresholdPairs = 0;
+    for (int block = 0; block < 2000; ++block) {
+        const Point sender{CENTER_LAT + offset(rng), CENTER_LON + offset(rng)};
+        const double senderRadius = 50.0 + unit(rng) * 250.0;
+        // Tailles variées : reliquat impair du chemin SSE2, blocs tronqués à BLOCK_SIZE
+        const int count = block % 3 == 0 ? Proximity::BLOCK_SIZE + 5 : 1 + block % Proximity::BLOCK_SIZE;
+        std::vector<double> xs(count), ys(count), radii(count);
+        std::vector<int> expected(count);
+        std::vector<bool> ambiguous(count, false);
+
+        double sx, sy;
+        frame.toLocal(sender.lat, sender.lon, sx, sy);
+        for (int i = 0; i < count; ++i) {
+            radii[i] = 50.0 + unit(rng) * 250.0;
+            const double range = senderRadius + radii[i];
+            double meters;
+            if (i % 2 == 0) {
+                const double side = i % 4 == 0 ? 1.0 - THRESHOLD_MARGIN : 1.0 + THRESHOLD_MARGIN;
+                meters = range * side;
+                ++nearThresholdPairs;
+            } else {
+                meters = unit(rng) * 2.0 * range;
+            }
+            const Point receiver = destination(sender, unit(rng) * 2.0 * M_PI, meters);
+            frame.toLocal(receiver.lat, receiver.lon, xs[i], ys[i]);
+            const double reference = Proximity::haversineMeters(sender.lat, sender.lon, receiver.lat, receiver.lon);
+            expected[i] = reference <= range ? 1 : 0;
+            // Paires aléatoires dans la marge d'erreur de la projection : non significatives
+            ambiguous[i] = std::abs(reference - range) <= range * MAX_RELATIVE_ERROR;
+        }
+
+        const quint64 mask = Proximity::inRangeMask(sx, sy, senderRadius, xs.data(), ys.data(), radii.data(), count);
+        for (int i = 0; i < count; ++i) {
+            if (i >= Proximity::BLOCK_SIZE) break;
+            if (ambiguous[i]) continue;
+            const int bit = static_cast<int>((mask >> i) & 1u);
+            check(bit == expected[i], "bit de portée", bit, expected[i]);
+            ++maskedPairs;
+        }
+    }
+
+    std::printf("écart relatif max : %.5f %% ; %d paires masquées (%d près du seuil) ; %d échecs\n",
+                maxRelativeError * 100.0, maskedPairs, nearThresholdPairs, failures);
+    return failures == 0 ? 0 : 1;
+}
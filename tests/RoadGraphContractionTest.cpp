@@ -0,0 +1,196 @@
+// Fusion des chaînes de degré 2 (RoadGraph::contractDegreeTwoChains) sur de
+// petits graphes : chaîne en sens unique, chaîne à double sens (une arête
+// fusionnée par sens), boucle fermée et arrêt sur un changement d'attributs.
+
+#include "RoadGraph.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+constexpr double SEGMENT_METERS = 100.0;
+
+int failures = 0;
+
+void check(bool condition, const char* what, double a, double b) {
+    if (!condition) {
+        ++failures;
+        if (failures <= 20) {
+            std::fprintf(stderr, "ÉCHEC %s : %.3f / %.3f\n", what, a, b);
+        }
+    }
+}
+
+// Graphe construit comme par le chargeur : une arête orientée par segment et par
+// sens de circulation, identifiants OSM des nœuds à partir de 1
+class GraphBuilder {
+public:
+    int node(double lat, double lon) {
+        RoadNode node;
+        node.id = ++m_lastNodeId;
+        node.lat = lat;
+        node.lon = lon;
+        return graph.addNode(node);
+    }
+
+    int attributes(double maxSpeedKmh, bool oneway) {
+        WayAttributes attributes;
+        attributes.wayId = ++m_lastWayId;
+        attributes.maxSpeedKmh = maxSpeedKmh;
+        attributes.oneway = oneway;
+        return graph.addWayAttributes(attributes);
+    }
+
+    void segment(int from, int to, int attributeIndex) {
+        RoadEdge edge;
+        edge.id = ++m_lastEdgeId;
+        edge.fromNode = from;
+        edge.toNode = to;
+        edge.lengthMeters = SEGMENT_METERS;
+        edge.attributeIndex = attributeIndex;
+        graph.addEdge(edge);
+        if (!graph.wayAttributes().at(attributeIndex).oneway) {
+            edge.id = ++m_lastEdgeId;
+            edge.fromNode = to;
+            edge.toNode = from;
+            graph.addEdge(edge);
+        }
+    }
+
+    // Nœuds alignés d'ouest en est, reliés par des segments aux attributs donnés
+    std::vector<int> street(const std::vector<int>& attributePerSegment) {
+        std::vector<int> nodes{node(47.75, 7.33)};
+        for (int attributeIndex : attributePerSegment) {
+            nodes.push_back(node(47.75, 7.33 + nodes.size() * 0.001));
+            segment(nodes.at(nodes.size() - 2), nodes.back(), attributeIndex);
+        }
+        return nodes;
+    }
+
+    RoadGraph graph;
+
+private:
+    qint64 m_lastNodeId = 0;
+    qint64 m_lastEdgeId = 0;
+    qint64 m_lastWayId = 0;
+};
+
+// Arêtes fusionnées entre deux nœuds OSM, dans ce sens
+std::vector<const RoadEdge*> edgesBetween(const RoadGraph& graph, qint64 fromId, qint64 toId) {
+    std::vector<const RoadEdge*> edges;
+    for (const RoadEdge& edge : graph.edges()) {
+        if (graph.nodes().at(edge.fromNode).id == fromId && graph.nodes().at(edge.toNode).id == toId) {
+            edges.push_back(&edge);
+        }
+    }
+    return edges;
+}
+
+// Identifiants OSM des points de forme de l'arête, dans son sens
+std::vector<qint64> shapeIds(const RoadGraph& graph, const RoadEdge& edge) {
+    std::vector<qint64> ids;
+    for (int k = edge.shapeBegin; k < edge.shapeEnd; ++k) {
+        ids.push_back(graph.shapePoints().at(k).id);
+    }
+    return ids;
+}
+
+void checkMergedEdge(const RoadGraph& graph, qint64 fromId, qint64 toId, const std::vector<qint64>& shape,
+                     const char* what) {
+    const std::vector<const RoadEdge*> edges = edgesBetween(graph, fromId, toId);
+    check(edges.size() == 1, what, static_cast<double>(edges.size()), 1.0);
+    if (edges.size() != 1) return;
+    check(shapeIds(graph, *edges.front()) == shape, what, static_cast<double>(edges.front()->shapeEnd - edges.front()->shapeBegin),
+          static_cast<double>(shape.size()));
+    check(std::abs(edges.front()->lengthMeters - SEGMENT_METERS * (shape.size() + 1)) < 1e-9, what,
+          edges.front()->lengthMeters, SEGMENT_METERS * (shape.size() + 1));
+}
+
+// Adjacence et géométrie se construisent sur le graphe fusionné ; les points de
+// forme tombent sur la polyligne
+void checkBuilds(RoadGraph& graph, const char* what) {
+    graph.buildAdjacency();
+    graph.buildGeometry();
+    int outgoing = 0;
+    for (int n = 0; n < graph.nodes().size(); ++n) {
+        outgoing += graph.outgoingEdges(n).size();
+    }
+    check(outgoing == graph.edges().size(), what, outgoing, graph.edges().size());
+    for (int e = 0; e < graph.edges().size(); ++e) {
+        check(graph.edgeById(graph.edges().at(e).id) == &graph.edges().at(e), what, e, -1.0);
+    }
+}
+} // namespace
+
+int main() {
+    // 1. Sens unique 1 -> 2 -> 3 -> 4 -> 5 : une arête 1 -> 5, points de forme 2, 3, 4
+    {
+        GraphBuilder builder;
+        const int oneway = builder.attributes(50.0, true);
+        builder.street({oneway, oneway, oneway, oneway});
+        const int removed = builder.graph.contractDegreeTwoChains();
+        check(removed == 3, "sens unique : arêtes supprimées", removed, 3);
+        check(builder.graph.nodes().size() == 2, "sens unique : nœuds", builder.graph.nodes().size(), 2);
+        check(builder.graph.edges().size() == 1, "sens unique : arêtes", builder.graph.edges().size(), 1);
+        check(builder.graph.nodeIndex(3) == -1, "sens unique : nœud intérieur retiré", builder.graph.nodeIndex(3), -1);
+        checkMergedEdge(builder.graph, 1, 5, {2, 3, 4}, "sens unique : arête 1 -> 5");
+        checkBuilds(builder.graph, "sens unique : adjacence");
+    }
+
+    // 2. Double sens 1 <-> 5 : exactement une arête fusionnée par sens
+    {
+        GraphBuilder builder;
+        const int twoWay = builder.attributes(50.0, false);
+        builder.street({twoWay, twoWay, twoWay, twoWay});
+        builder.graph.contractDegreeTwoChains();
+        check(builder.graph.edges().size() == 2, "double sens : arêtes", builder.graph.edges().size(), 2);
+        checkMergedEdge(builder.graph, 1, 5, {2, 3, 4}, "double sens : arête 1 -> 5");
+        checkMergedEdge(builder.graph, 5, 1, {4, 3, 2}, "double sens : arête 5 -> 1");
+        checkBuilds(builder.graph, "double sens : adjacence");
+    }
+
+    // 3. Boucle fermée en sens unique de six nœuds : un nœud conservé, une arête
+    //    de ce nœud vers lui-même passant par les cinq autres
+    {
+        GraphBuilder builder;
+        const int oneway = builder.attributes(30.0, true);
+        std::vector<int> ring;
+        for (int k = 0; k < 6; ++k) {
+            ring.push_back(builder.node(47.75 + 0.001 * std::cos(k * M_PI / 3.0), 7.33 + 0.001 * std::sin(k * M_PI / 3.0)));
+        }
+        for (int k = 0; k < 6; ++k) {
+            builder.segment(ring.at(k), ring.at((k + 1) % 6), oneway);
+        }
+        builder.graph.contractDegreeTwoChains();
+        check(builder.graph.nodes().size() == 1, "boucle : nœuds", builder.graph.nodes().size(), 1);
+        check(builder.graph.edges().size() == 1, "boucle : arêtes", builder.graph.edges().size(), 1);
+        checkMergedEdge(builder.graph, 1, 1, {2, 3, 4, 5, 6}, "boucle : arête 1 -> 1");
+        checkBuilds(builder.graph, "boucle : adjacence");
+    }
+
+    // 4. Changement de vitesse au nœud 3 : la fusion s'y arrête, une arête par
+    //    sens de chaque côté
+    {
+        GraphBuilder builder;
+        const int slow = builder.attributes(30.0, false);
+        const int fast = builder.attributes(50.0, false);
+        builder.street({slow, slow, fast, fast});
+        builder.graph.contractDegreeTwoChains();
+        check(builder.graph.nodes().size() == 3, "attributs : nœuds", builder.graph.nodes().size(), 3);
+        check(builder.graph.nodeIndex(3) >= 0, "attributs : nœud 3 conservé", builder.graph.nodeIndex(3), 0);
+        check(builder.graph.edges().size() == 4, "attributs : arêtes", builder.graph.edges().size(), 4);
+        checkMergedEdge(builder.graph, 1, 3, {2}, "attributs : arête 1 -> 3");
+        checkMergedEdge(builder.graph, 3, 1, {2}, "attributs : arête 3 -> 1");
+        checkMergedEdge(builder.graph, 3, 5, {4}, "attributs : arête 3 -> 5");
+        checkMergedEdge(builder.graph, 5, 3, {4}, "attributs : arête 5 -> 3");
+        for (const RoadEdge* edge : edgesBetween(builder.graph, 1, 3)) {
+            check(builder.graph.wayAttributes().at(edge->attributeIndex).maxSpeedKmh == 30.0, "attributs : vitesse 1 -> 3",
+                  builder.graph.wayAttributes().at(edge->attributeIndex).maxSpeedKmh, 30.0);
+        }
+        checkBuilds(builder.graph, "attributs : adjacence");
+    }
+
+    std::printf("%d échecs\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+// Itinéraires sur la hiérarchie de contraction (RouteQuery::route) et matrice
+// de temps de parcours (TravelTimeMatrix::compute) comparés à un Dijkstra simple
+// sur le graphe d'origine : grille avec des sens uniques, une composante isolée
+// et un cul-de-sac à sens unique (paires inaccessibles), source == cible comprise.
+// Vérifie aussi la sauvegarde/relecture de la hiérarchie et le rejet d'une
+// hiérarchie construite pour un autre graphe.
+
+#include "ContractionHierarchy.h"
+#include "RoadGraph.h"
+#include "ThreadPool.h"
+#include "TravelTimeMatrix.h"
+
+#include <QTemporaryDir>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr int GRID_SIDE = 12;
+constexpr double MAX_RELATIVE_ERROR = 1e-9; // Sommes de poids dans un ordre différent
+constexpr double INFINITE_SECONDS = std::numeric_limits<double>::infinity();
+
+int failures = 0;
+
+void check(bool condition, const char* what, double a, double b) {
+    if (!condition) {
+        ++failures;
+        if (failures <= 20) {
+            std::fprintf(stderr, "ÉCHEC %s : %.9f / %.9f\n", what, a, b);
+        }
+    }
+}
+
+bool sameSeconds(double a, double b) {
+    if (std::isinf(a) || std::isinf(b)) return a == b;
+    return std::abs(a - b) <= MAX_RELATIVE_ERROR * std::max(1.0, std::abs(b));
+}
+
+// Grille GRID_SIDE x GRID_SIDE (indices 0 .. GRID_SIDE² - 1), vitesses variées,
+// rues horizontales à sens unique une sur trois (sens alterné d'une rangée à
+// l'autre) ; puis deux nœuds reliés entre eux seulement (composante isolée) et
+// un nœud atteint par une seule arête à sens unique (on n'en ressort pas).
+// changedEdge : arête dont la vitesse est modifiée (-1 : aucune)
+RoadGraph makeGraph(int changedEdge = -1) {
+    std::mt19937_64 rng(20240805);
+    std::uniform_real_distribution<double> jitter(-0.0002, 0.0002);
+    RoadGraph graph;
+    auto addNode = [&graph](double lat, double lon) {
+        RoadNode node;
+        node.id = graph.nodes().size() + 1;
+        node.lat = lat;
+        node.lon = lon;
+        return graph.addNode(node);
+    };
+    auto addEdge = [&graph, changedEdge](int from, int to, double lengthMeters, double speedKmh, bool oneway) {
+        const int edgeIndex = graph.edges().size();
+        WayAttributes attributes;
+        attributes.wayId = edgeIndex + 1;
+        attributes.maxSpeedKmh = edgeIndex == changedEdge ? speedKmh + 20.0 : speedKmh;
+        attributes.oneway = oneway;
+        RoadEdge edge;
+        edge.id = edgeIndex + 1;
+        edge.fromNode = from;
+        edge.toNode = to;
+        edge.lengthMeters = lengthMeters;
+        edge.attributeIndex = graph.addWayAttributes(attributes);
+        graph.addEdge(edge);
+    };
+
+    for (int y = 0; y < GRID_SIDE; ++y) {
+        for (int x = 0; x < GRID_SIDE; ++x) {
+            addNode(47.74 + y * 0.001 + jitter(rng), 7.32 + x * 0.0015 + jitter(rng));
+        }
+    }
+    for (int y = 0; y < GRID_SIDE; ++y) {
+        for (int x = 0; x < GRID_SIDE; ++x) {
+            const int node = y * GRID_SIDE + x;
+            const double speedKmh = 30.0 + (node % 4) * 10.0;
+            if (x + 1 < GRID_SIDE) {
+                const bool oneway = y % 3 == 1;
+                const bool eastward = y % 2 == 0;
+                addEdge(oneway && !eastward ? node + 1 : node, oneway && !eastward ? node : node + 1,
+                        110.0 + (node % 7), speedKmh, oneway);
+            }
+            if (y + 1 < GRID_SIDE) {
+                addEdge(node, node + GRID_SIDE, 111.0 + (node % 5), speedKmh, false);
+            }
+        }
+    }
+
+    const int islandA = addNode(47.70, 7.30);
+    const int islandB = addNode(47.70, 7.301);
+    addEdge(islandA, islandB, 80.0, 50.0, false);
+    const int deadEnd = addNode(47.739, 7.32);
+    addEdge(0, deadEnd, 120.0, 30.0, true);
+
+    graph.buildAdjacency();
+    graph.buildGeometry();
+    return graph;
+}
+
+// Dijkstra de référence depuis source, arêtes non oneway dans les deux sens
+std::vector<double> dijkstra(const RoadGraph& graph, int source) {
+    const int nodeCount = graph.nodes().size();
+    std::vector<std::vector<std::pair<int, double>>> arcs(nodeCount);
+    for (int i = 0; i < graph.edges().size(); ++i) {
+        const RoadEdge& edge = graph.edges().at(i);
+        const double seconds = ContractionHierarchy::travelTimeSeconds(graph, i);
+        arcs[edge.fromNode].push_back({edge.toNode, seconds});
+        if (!graph.edgeAttributes(i).oneway) {
+            arcs[edge.toNode].push_back({edge.fromNode, seconds});
+        }
+    }
+
+    std::vector<double> distance(nodeCount, INFINITE_SECONDS);
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distance[source] = 0.0;
+    queue.push({0.0, source});
+    while (!queue.empty()) {
+        const auto [seconds, node] = queue.top();
+        queue.pop();
+        if (seconds > distance[node]) continue;
+        for (const auto& [next, weight] : arcs[node]) {
+            if (seconds + weight < distance[next]) {
+                distance[next] = seconds + weight;
+                queue.push({distance[next], next});
+            }
+        }
+    }
+    return distance;
+}
+
+// Les étapes forment un chemin praticable de source à target ; retourne sa durée
+double checkSteps(const RoadGraph& graph, const QVector<RouteStep>& steps, int source, int target) {
+    int node = source;
+    double seconds = 0.0;
+    for (const RouteStep& step : steps) {
+        const RoadEdge& edge = graph.edges().at(step.edgeIndex);
+        check(step.forward || !graph.edgeAttributes(step.edgeIndex).oneway, "sens interdit", step.edgeIndex, node);
+        check((step.forward ? edge.fromNode : edge.toNode) == node, "étapes non chaînées", step.edgeIndex, node);
+        node = step.forward ? edge.toNode : edge.fromNode;
+        seconds += ContractionHierarchy::travelTimeSeconds(graph, step.edgeIndex);
+    }
+    check(node == target, "fin de l'itinéraire", node, target);
+    return seconds;
+}
+} // namespace
+
+int main() {
+    const RoadGraph graph = makeGraph();
+    const int nodeCount = graph.nodes().size();
+    const ContractionHierarchy hierarchy = ContractionHierarchy::build(graph);
+    check(hierarchy.matches(graph), "hiérarchie construite", hierarchy.nodeCount(), nodeCount);
+
+    std::vector<std::vector<double>> expected(nodeCount);
+    for (int source = 0; source < nodeCount; ++source) {
+        expected[source] = dijkstra(graph, source);
+    }
+
+    // 1. Itinéraires de chaque nœud vers chaque nœud
+    int unreachablePairs = 0;
+    RouteQuery query;
+    QVector<RouteStep> steps;
+    for (int source = 0; source < nodeCount; ++source) {
+        for (int target = 0; target < nodeCount; ++target) {
+            double seconds = -1.0;
+            const bool found = query.route(hierarchy, source, target, steps, &seconds);
+            const double reference = expected[source][target];
+            check(found == std::isfinite(reference), "itinéraire trouvé", source, target);
+            if (!found) {
+                ++unreachablePairs;
+                check(steps.isEmpty(), "étapes d'un itinéraire inaccessible", source, target);
+                continue;
+            }
+            check(sameSeconds(seconds, reference), "durée de l'itinéraire", seconds, reference);
+            check(sameSeconds(checkSteps(graph, steps, source, target), reference), "durée des étapes",
+                  seconds, reference);
+            if (source == target) {
+                check(steps.isEmpty() && seconds == 0.0, "source == cible", source, seconds);
+            }
+        }
+    }
+    check(unreachablePairs > 0, "paires inaccessibles", unreachablePairs, 0);
+
+    // 2. Matrice complète, identique quel que soit le nombre de threads
+    QVector<int> nodes(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        nodes[i] = i;
+    }
+    ThreadPool singleThread(1);
+    ThreadPool pool(4);
+    const TravelTimeMatrix matrix = TravelTimeMatrix::compute(hierarchy, nodes, nodes, pool);
+    const TravelTimeMatrix singleThreadMatrix = TravelTimeMatrix::compute(hierarchy, nodes, nodes, singleThread);
+    check(matrix.sourceCount() == nodeCount && matrix.targetCount() == nodeCount, "taille de la matrice",
+          matrix.sourceCount(), matrix.targetCount());
+    check(singleThreadMatrix.values().size() == matrix.values().size()
+              && std::memcmp(matrix.values().constData(), singleThreadMatrix.values().constData(),
+                             sizeof(double) * matrix.values().size()) == 0,
+          "matrice selon le nombre de threads", matrix.values().size(), singleThreadMatrix.values().size());
+    for (int source = 0; source < nodeCount; ++source) {
+        for (int target = 0; target < nodeCount; ++target) {
+            const double reference = expected[source][target];
+            check(matrix.isReachable(source, target) == std::isfinite(reference), "cible accessible",
+                  source, target);
+            check(sameSeconds(matrix.seconds(source, target), reference), "temps de la matrice",
+                  matrix.seconds(source, target), reference);
+        }
+    }
+
+    // 3. Sauvegarde puis relecture : mêmes itinéraires ; rejet pour un graphe modifié
+    QTemporaryDir directory;
+    check(directory.isValid(), "répertoire temporaire", 0, 0);
+    const QString path = directory.filePath(QStringLiteral("routing.chcache"));
+    QString error;
+    check(hierarchy.save(path, &error), "sauvegarde", 0, 0);
+
+    ContractionHierarchy loaded;
+    check(ContractionHierarchy::load(path, graph, loaded, &error), "relecture", 0, 0);
+    check(loaded.matches(graph) && loaded.shortcutCount() == hierarchy.shortcutCount(), "hiérarchie relue",
+          loaded.shortcutCount(), hierarchy.shortcutCount());
+    RouteQuery loadedQuery;
+    QVector<RouteStep> loadedSteps;
+    for (int source = 0; source < nodeCount; source += 7) {
+        for (int target = 0; target < nodeCount; ++target) {
+            double seconds = -1.0;
+            double loadedSeconds = -1.0;
+            const bool found = query.route(hierarchy, source, target, steps, &seconds);
+            const bool loadedFound = loadedQuery.route(loaded, source, target, loadedSteps, &loadedSeconds);
+            bool sameSteps = steps.size() == loadedSteps.size();
+            for (int i = 0; sameSteps && i < steps.size(); ++i) {
+                sameSteps = steps.at(i).edgeIndex == loadedSteps.at(i).edgeIndex
+                            && steps.at(i).forward == loadedSteps.at(i).forward;
+            }
+            check(found == loadedFound && seconds == loadedSeconds && sameSteps, "itinéraire relu",
+                  seconds, loadedSeconds);
+        }
+    }
+
+    const RoadGraph modified = makeGraph(GRID_SIDE + 3);
+    ContractionHierarchy rejected;
+    error.clear();
+    check(!hierarchy.matches(modified), "empreinte du graphe modifié", 0, 0);
+    check(!ContractionHierarchy::load(path, modified, rejected, &error), "relecture pour un graphe modifié", 0, 0);
+    check(rejected.isEmpty() && !error.isEmpty(), "hiérarchie rejetée", rejected.nodeCount(), 0);
+
+    std::printf("%d nœuds, %d raccourcis, %d paires inaccessibles ; %d échecs\n", nodeCount,
+                hierarchy.shortcutCount(), unreachablePairs, failures);
+    return failures == 0 ? 0 : 1;
+}